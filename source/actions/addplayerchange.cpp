@@ -17,7 +17,7 @@
   
 #include "addplayerchange.h"
 
-#include <score/system.h>
+#include <score/score.h>
 
 AddPlayerChange::AddPlayerChange(const ScoreLocation &location,
                                  const PlayerChange &change)
@@ -31,9 +31,11 @@ AddPlayerChange::AddPlayerChange(const ScoreLocation &location,
 void AddPlayerChange::redo()
 {
     myLocation.getSystem().insertPlayerChange(myPlayerChange);
+    myLocation.getScore().updatePlayerChangeIndex(myLocation.getSystemIndex());
 }
 
 void AddPlayerChange::undo()
 {
     myLocation.getSystem().removePlayerChange(myPlayerChange);
+    myLocation.getScore().updatePlayerChangeIndex(myLocation.getSystemIndex());
 }
@@ -0,0 +1,71 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dirtyregion.h"
+
+#include <score/scorelocation.h>
+
+DirtyRegion::DirtyRegion() : DirtyRegion(-1)
+{
+}
+
+DirtyRegion::DirtyRegion(int system) : DirtyRegion(system, -1)
+{
+}
+
+DirtyRegion::DirtyRegion(int system, int staff)
+    : mySystemIndex(system), myStaffIndex(staff)
+{
+}
+
+DirtyRegion DirtyRegion::fromLocation(const ScoreLocation &location)
+{
+    return DirtyRegion(location.getSystemIndex(), location.getStaffIndex());
+}
+
+DirtyRegion DirtyRegion::merge(const DirtyRegion &other) const
+{
+    if (isEntireScore() || other.isEntireScore() ||
+        mySystemIndex != other.mySystemIndex)
+    {
+        return DirtyRegion();
+    }
+    else if (myStaffIndex != other.myStaffIndex)
+        return DirtyRegion(mySystemIndex);
+    else
+        return *this;
+}
+
+bool DirtyRegion::isEntireScore() const
+{
+    return mySystemIndex < 0;
+}
+
+bool DirtyRegion::isEntireSystem() const
+{
+    return myStaffIndex < 0;
+}
+
+int DirtyRegion::getSystemIndex() const
+{
+    return mySystemIndex;
+}
+
+int DirtyRegion::getStaffIndex() const
+{
+    return myStaffIndex;
+}
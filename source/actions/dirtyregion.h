@@ -0,0 +1,52 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ACTIONS_DIRTYREGION_H
+#define ACTIONS_DIRTYREGION_H
+
+class ScoreLocation;
+
+/// Describes the part of the score that is modified by an undo command, so
+/// that the views only need to update that part of the score.
+class DirtyRegion
+{
+public:
+    /// Creates a region covering the entire score.
+    DirtyRegion();
+    /// Creates a region covering an entire system.
+    explicit DirtyRegion(int system);
+    /// Creates a region covering a single staff.
+    DirtyRegion(int system, int staff);
+
+    /// Creates a region covering the location's current staff.
+    static DirtyRegion fromLocation(const ScoreLocation &location);
+
+    /// Returns the smallest region that covers both regions.
+    DirtyRegion merge(const DirtyRegion &other) const;
+
+    bool isEntireScore() const;
+    bool isEntireSystem() const;
+
+    int getSystemIndex() const;
+    int getStaffIndex() const;
+
+private:
+    int mySystemIndex;
+    int myStaffIndex;
+};
+
+#endif
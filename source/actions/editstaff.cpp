@@ -21,7 +21,7 @@
 
 EditStaff::EditStaff(const ScoreLocation &location, Staff::ClefType clef,
     int strings)
-    : QUndoCommand(QObject::tr("Edit Staff")),
+    : SnapshotCommand(QObject::tr("Edit Staff")),
     myLocation(location),
     myClef(clef),
     myNumStrings(strings)
@@ -76,13 +76,34 @@ void EditStaff::undo()
 
     if (myOriginalNextSystem)
         score.getSystems()[system_index + 1] = *myOriginalNextSystem;
+
+    score.updatePlayerChangeIndex(system_index);
+
+    // Don't keep sharing data with the score, so that a later modification
+    // doesn't need to copy it.
+    discardSnapshot();
+}
+
+size_t EditStaff::getMemoryUsage(CountedValueSet &counted) const
+{
+    size_t size = myOriginalSystem.getMemoryUsage(counted);
+    if (myOriginalNextSystem)
+        size += myOriginalNextSystem->getMemoryUsage(counted);
+
+    return size;
+}
+
+void EditStaff::discardSnapshot()
+{
+    myOriginalSystem = System();
+    myOriginalNextSystem.reset();
 }
 
 void EditStaff::addPlayerChangeAtStart(Score &score, int system_index)
 {
     System &system = score.getSystems()[system_index];
     const PlayerChange *current_players =
-        ScoreUtils::getCurrentPlayers(score, system_index, 0);
+        score.getCurrentPlayers(system_index, 0);
 
     if (current_players &&
         (system.getPlayerChanges().empty() ||
@@ -91,5 +112,6 @@ void EditStaff::addPlayerChangeAtStart(Score &score, int system_index)
         PlayerChange change(*current_players);
         change.setPosition(0);
         system.insertPlayerChange(change);
+        score.updatePlayerChangeIndex(system_index);
     }
 }
@@ -19,11 +19,11 @@
 #define ACTIONS_EDITCLEF_H
 
 #include <boost/optional.hpp>
-#include <QUndoCommand>
 #include <score/scorelocation.h>
 #include <score/system.h>
+#include "snapshotcommand.h"
 
-class EditStaff : public QUndoCommand
+class EditStaff : public SnapshotCommand
 {
 public:
     EditStaff(const ScoreLocation &location, Staff::ClefType clef, int strings);
@@ -31,6 +31,9 @@ public:
     virtual void redo() override;
     virtual void undo() override;
 
+    virtual size_t getMemoryUsage(CountedValueSet &counted) const override;
+    virtual void discardSnapshot() override;
+
 private:
     static void addPlayerChangeAtStart(Score &score, int system_index);
 
@@ -21,7 +21,7 @@
 #include <score/utils/scorepolisher.h>
 
 PolishScore::PolishScore(Score &score)
-    : QUndoCommand(QObject::tr("Polish Score")), myScore(score)
+    : SnapshotCommand(QObject::tr("Polish Score")), myScore(score)
 {
 }
 
@@ -40,3 +40,18 @@ void PolishScore::undo()
 
     myOriginalSystems.clear();
 }
+
+size_t PolishScore::getMemoryUsage(CountedValueSet &counted) const
+{
+    size_t size = 0;
+    for (const System &system : myOriginalSystems)
+        size += system.getMemoryUsage(counted);
+
+    return size;
+}
+
+void PolishScore::discardSnapshot()
+{
+    myOriginalSystems.clear();
+    myOriginalSystems.shrink_to_fit();
+}
@@ -18,12 +18,12 @@
 #ifndef ACTIONS_POLISHSCORE_H
 #define ACTIONS_POLISHSCORE_H
 
-#include <QUndoCommand>
+#include "snapshotcommand.h"
 #include <score/system.h>
 
 class Score;
 
-class PolishScore : public QUndoCommand
+class PolishScore : public SnapshotCommand
 {
 public:
     PolishScore(Score &score);
@@ -31,6 +31,9 @@ public:
     virtual void redo() override;
     virtual void undo() override;
 
+    virtual size_t getMemoryUsage(CountedValueSet &counted) const override;
+    virtual void discardSnapshot() override;
+
 private:
     Score &myScore;
     std::vector<System> myOriginalSystems;
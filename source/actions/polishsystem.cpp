@@ -20,7 +20,7 @@
 #include <score/utils/scorepolisher.h>
 
 PolishSystem::PolishSystem(const ScoreLocation &location)
-    : QUndoCommand(QObject::tr("Polish System")), myLocation(location)
+    : SnapshotCommand(QObject::tr("Polish System")), myLocation(location)
 {
 }
 
@@ -35,3 +35,13 @@ void PolishSystem::undo()
     myLocation.getSystem() = *myOriginalSystem;
     myOriginalSystem.reset();
 }
+
+size_t PolishSystem::getMemoryUsage(CountedValueSet &counted) const
+{
+    return myOriginalSystem ? myOriginalSystem->getMemoryUsage(counted) : 0;
+}
+
+void PolishSystem::discardSnapshot()
+{
+    myOriginalSystem.reset();
+}
@@ -18,13 +18,13 @@
 #ifndef ACTIONS_POLISHSYSTEM_H
 #define ACTIONS_POLISHSYSTEM_H
 
-#include <QUndoCommand>
+#include "snapshotcommand.h"
 
 #include <boost/optional/optional.hpp>
 #include <score/scorelocation.h>
 #include <score/system.h>
 
-class PolishSystem : public QUndoCommand
+class PolishSystem : public SnapshotCommand
 {
 public:
     PolishSystem(const ScoreLocation &location);
@@ -32,6 +32,9 @@ public:
     virtual void redo() override;
     virtual void undo() override;
 
+    virtual size_t getMemoryUsage(CountedValueSet &counted) const override;
+    virtual void discardSnapshot() override;
+
 private:
     ScoreLocation myLocation;
     boost::optional<System> myOriginalSystem;
@@ -20,19 +20,30 @@
 #include <score/score.h>
 
 RemoveSystem::RemoveSystem(Score &score, int index)
-    : QUndoCommand(QObject::tr("Remove System")),
+    : SnapshotCommand(QObject::tr("Remove System")),
       myScore(score),
-      myIndex(index),
-      myOriginalSystem(score.getSystems()[index])
+      myIndex(index)
 {
 }
 
 void RemoveSystem::redo()
 {
+    myOriginalSystem = myScore.getSystems()[myIndex];
     myScore.removeSystem(myIndex);
 }
 
 void RemoveSystem::undo()
 {
-    myScore.insertSystem(myOriginalSystem, myIndex);
+    myScore.insertSystem(*myOriginalSystem, myIndex);
+    myOriginalSystem.reset();
+}
+
+size_t RemoveSystem::getMemoryUsage(CountedValueSet &counted) const
+{
+    return myOriginalSystem ? myOriginalSystem->getMemoryUsage(counted) : 0;
+}
+
+void RemoveSystem::discardSnapshot()
+{
+    myOriginalSystem.reset();
 }
@@ -18,12 +18,13 @@
 #ifndef ACTIONS_REMOVESYSTEM_H
 #define ACTIONS_REMOVESYSTEM_H
 
-#include <QUndoCommand>
+#include <boost/optional/optional.hpp>
 #include <score/system.h>
+#include "snapshotcommand.h"
 
 class Score;
 
-class RemoveSystem : public QUndoCommand
+class RemoveSystem : public SnapshotCommand
 {
 public:
     RemoveSystem(Score &score, int index);
@@ -31,10 +32,13 @@ public:
     virtual void redo() override;
     virtual void undo() override;
 
+    virtual size_t getMemoryUsage(CountedValueSet &counted) const override;
+    virtual void discardSnapshot() override;
+
 private:
     Score &myScore;
     const int myIndex;
-    const System myOriginalSystem;
+    boost::optional<System> myOriginalSystem;
 };
 
 #endif
@@ -0,0 +1,45 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef ACTIONS_SNAPSHOTCOMMAND_H
+#define ACTIONS_SNAPSHOTCOMMAND_H
+
+#include <cstddef>
+#include <QUndoCommand>
+#include <util/copyonwrite.h>
+
+/// Base class for undo commands that store a copy of part of the score, which
+/// allows the UndoManager to limit the memory used by the undo history.
+class SnapshotCommand : public QUndoCommand
+{
+public:
+    explicit SnapshotCommand(const QString &text) : QUndoCommand(text)
+    {
+    }
+
+    /// Returns the approximate amount of memory used by the snapshot,
+    /// excluding any shared data that was already counted (e.g. because it is
+    /// shared with the score or with a newer snapshot).
+    virtual size_t getMemoryUsage(CountedValueSet &counted) const = 0;
+
+    /// Frees the snapshot. This is done once the command can no longer be
+    /// undone, or after undoing the command since redoing it takes a new
+    /// snapshot.
+    virtual void discardSnapshot() = 0;
+};
+
+#endif
@@ -17,14 +17,25 @@
 
 #include "undomanager.h"
 
+#include <QAction>
+#include <score/score.h>
+#include "snapshotcommand.h"
+
+UndoManager::History::History(const Score &score)
+    : myScore(&score), myMemoryUsage(0), myMinIndex(0)
+{
+}
+
 UndoManager::UndoManager(QObject *parent) :
-    QUndoGroup(parent)
+    QUndoGroup(parent),
+    myMemoryBudget(DEFAULT_MEMORY_BUDGET)
 {
 }
 
-void UndoManager::addNewUndoStack()
+void UndoManager::addNewUndoStack(const Score &score)
 {
     undoStacks.emplace_back(new QUndoStack);
+    myHistories.emplace_back(score);
     addStack(undoStacks.back().get());
 }
 
@@ -40,6 +51,7 @@ void UndoManager::removeStack(int index)
 {
     // Stack is automatically removed from the QUndoGroup when it is deleted.
     undoStacks.erase(undoStacks.begin() + index);
+    myHistories.erase(myHistories.begin() + index);
 }
 
 void UndoManager::push(QUndoCommand *cmd)
@@ -49,61 +61,232 @@ void UndoManager::push(QUndoCommand *cmd)
 
 void UndoManager::push(QUndoCommand *cmd, int affectedSystem)
 {
-    beginMacro(cmd->actionText());
+    push(cmd, affectedSystem >= 0 ? DirtyRegion(affectedSystem)
+                                  : DirtyRegion());
+}
+
+void UndoManager::push(QUndoCommand *cmd, const DirtyRegion &region)
+{
+    openMacro(cmd->actionText(), true);
 
-    auto onUndo = new SignalOnUndo();
-    if (affectedSystem >= 0)
+    if (auto snapshot = dynamic_cast<SnapshotCommand *>(cmd))
     {
-        connect(onUndo, &SignalOnUndo::triggered, [=]() {
-            onSystemChanged(affectedSystem);
-        });
+        QUndoStack *stack = activeStack();
+        myHistories.at(indexOfStack(stack))
+            .mySnapshots.push_back({ stack->index() + 1, snapshot, 0 });
     }
-    else
+
+    addDirtyRegion(region);
+    push(cmd);
+    closeMacro();
+
+    enforceMemoryBudget();
+}
+
+void UndoManager::setClean()
+{
+    activeStack()->setClean();
+}
+
+void UndoManager::setMemoryBudget(size_t bytes)
+{
+    myMemoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+size_t UndoManager::getMemoryUsage() const
+{
+    const int index = indexOfStack(activeStack());
+    return index >= 0 ? myHistories[index].myMemoryUsage : 0;
+}
+
+bool UndoManager::canUndo() const
+{
+    const QUndoStack *stack = activeStack();
+    if (!stack || !stack->canUndo())
+        return false;
+
+    return stack->index() > myHistories[indexOfStack(stack)].myMinIndex;
+}
+
+void UndoManager::undo()
+{
+    if (canUndo())
+        activeStack()->undo();
+}
+
+QAction *UndoManager::createUndoAction(QObject *parent, const QString &prefix)
+{
+    auto action = new QAction(parent);
+
+    auto update = [=]() {
+        const bool enabled = canUndo();
+        action->setEnabled(enabled);
+
+        const QString text = enabled ? undoText() : QString();
+        if (prefix.isEmpty())
+            action->setText(text.isEmpty() ? tr("Undo") : tr("Undo %1").arg(text));
+        else if (text.isEmpty())
+            action->setText(prefix);
+        else
+            action->setText(prefix + QLatin1Char(' ') + text);
+    };
+
+    connect(this, &QUndoGroup::activeStackChanged, action, update);
+    connect(this, &QUndoGroup::indexChanged, action, update);
+    connect(this, &QUndoGroup::canUndoChanged, action, update);
+    connect(this, &QUndoGroup::undoTextChanged, action, update);
+    connect(this, &UndoManager::memoryUsageChanged, action, update);
+    connect(action, &QAction::triggered, this, &UndoManager::undo);
+
+    update();
+    return action;
+}
+
+void UndoManager::enforceMemoryBudget()
+{
+    QUndoStack *stack = activeStack();
+    if (!stack)
+        return;
+
+    History &history = myHistories.at(indexOfStack(stack));
+
+    // Avoid walking the whole score for commands that don't use snapshots.
+    if (history.mySnapshots.empty())
     {
-        connect(onUndo, &SignalOnUndo::triggered, this,
-                &UndoManager::fullRedrawNeeded);
+        history.myMemoryUsage = 0;
+        emit memoryUsageChanged(history.myMemoryUsage);
+        return;
     }
 
-    push(onUndo);
-    push(cmd);
+    // The memory used by a snapshot increases as the score is modified and
+    // less of it is shared, so recompute the total. Data that is still shared
+    // with the score doesn't use any additional memory.
+    CountedValueSet counted;
+    for (const System &system : history.myScore->getSystems())
+        system.getMemoryUsage(counted);
 
-    auto onRedo = new SignalOnRedo();
-    if (affectedSystem >= 0)
+    // Data that is shared between snapshots is only counted for the newest
+    // one, since discarding an older snapshot doesn't free it.
+    history.myMemoryUsage = 0;
+    for (auto it = history.mySnapshots.rbegin();
+         it != history.mySnapshots.rend(); ++it)
     {
-        connect(onRedo, &SignalOnRedo::triggered, [=]() {
-            onSystemChanged(affectedSystem);
-        });
+        it->myMemoryUsage = it->myCommand->getMemoryUsage(counted);
+        history.myMemoryUsage += it->myMemoryUsage;
     }
-    else
+
+    // Discard the oldest snapshots. A command that is currently part of a
+    // macro can't be discarded until the macro is finished.
+    while (history.myMemoryUsage > myMemoryBudget &&
+           !history.mySnapshots.empty() &&
+           history.mySnapshots.front().myIndex <= stack->index())
     {
-        connect(onRedo, &SignalOnRedo::triggered, this,
-                &UndoManager::fullRedrawNeeded);
+        const Snapshot &snapshot = history.mySnapshots.front();
+        history.myMemoryUsage -= snapshot.myMemoryUsage;
+        snapshot.myCommand->discardSnapshot();
+        history.myMinIndex = snapshot.myIndex;
+        history.mySnapshots.pop_front();
     }
 
-    push(onRedo);
-    endMacro();
+    emit memoryUsageChanged(history.myMemoryUsage);
 }
 
-void UndoManager::setClean()
+int UndoManager::indexOfStack(const QUndoStack *stack) const
 {
-    activeStack()->setClean();
+    for (size_t i = 0; i < undoStacks.size(); ++i)
+    {
+        if (undoStacks[i].get() == stack)
+            return static_cast<int>(i);
+    }
+
+    return -1;
 }
 
-void UndoManager::onSystemChanged(int affectedSystem)
+void UndoManager::onRegionChanged(const DirtyRegion &region)
 {
-    emit redrawNeeded(affectedSystem);
+    if (region.isEntireScore())
+        emit fullRedrawNeeded();
+    else if (region.isEntireSystem())
+        emit redrawNeeded(region.getSystemIndex());
+    else
+        emit staffRedrawNeeded(region);
 }
 
 void UndoManager::beginMacro(const QString &text)
 {
-    activeStack()->beginMacro(text);
+    openMacro(text, false);
 }
 
 void UndoManager::endMacro()
 {
+    closeMacro();
+}
+
+void UndoManager::openMacro(const QString &text, bool isCommand)
+{
+    QUndoStack *stack = activeStack();
+
+    // Starting a new command deletes any commands that were undone. This
+    // can't be the case if a macro is already in progress.
+    if (stack->count() > stack->index())
+    {
+        History &history = myHistories.at(indexOfStack(stack));
+        while (!history.mySnapshots.empty() &&
+               history.mySnapshots.back().myIndex > stack->index())
+        {
+            history.mySnapshots.pop_back();
+        }
+    }
+
+    stack->beginMacro(text);
+
+    // The views are redrawn after undoing all of the macro's commands.
+    SignalOnUndo *onUndo = nullptr;
+    if (!isCommand || myPendingRedraws.empty())
+    {
+        onUndo = new SignalOnUndo();
+        push(onUndo);
+    }
+
+    myPendingRedraws.push_back({ onUndo, boost::none });
+}
+
+void UndoManager::closeMacro()
+{
+    const PendingRedraw pending = myPendingRedraws.back();
+    myPendingRedraws.pop_back();
+
+    if (pending.myRegion)
+    {
+        const DirtyRegion region = *pending.myRegion;
+
+        if (!pending.myOnUndo)
+            addDirtyRegion(region);
+        else
+        {
+            connect(pending.myOnUndo, &SignalOnUndo::triggered, [=]() {
+                onRegionChanged(region);
+            });
+
+            auto onRedo = new SignalOnRedo();
+            connect(onRedo, &SignalOnRedo::triggered, [=]() {
+                onRegionChanged(region);
+            });
+
+            push(onRedo);
+        }
+    }
+
     activeStack()->endMacro();
 }
 
+void UndoManager::addDirtyRegion(const DirtyRegion &region)
+{
+    boost::optional<DirtyRegion> &current = myPendingRedraws.back().myRegion;
+    current = current ? current->merge(region) : region;
+}
+
 void SignalOnRedo::redo()
 {
     emit triggered();
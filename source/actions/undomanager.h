@@ -18,12 +18,19 @@
 #ifndef ACTIONS_UNDOMANAGER_H
 #define ACTIONS_UNDOMANAGER_H
 
+#include <actions/dirtyregion.h>
+#include <boost/optional/optional.hpp>
+#include <deque>
 #include <memory>
 #include <QUndoGroup>
 #include <QUndoStack>
 #include <vector>
 
+class QAction;
 class QUndoCommand;
+class Score;
+class SignalOnUndo;
+class SnapshotCommand;
 
 class UndoManager : public QUndoGroup
 {
@@ -32,7 +39,8 @@ class UndoManager : public QUndoGroup
 public:
     explicit UndoManager(QObject *parent = nullptr);
 
-    void addNewUndoStack();
+    /// Adds an undo stack for the given score.
+    void addNewUndoStack(const Score &score);
     void setActiveStackIndex(int index);
     void removeStack(int index);
 
@@ -40,25 +48,111 @@ public:
     /// @param affectedSystem Index of the system that is modified by this action.
     /// Use -1 for actions that affect all systems.
     void push(QUndoCommand *cmd, int affectedSystem);
+    /// Pushes an undo command onto the active stack.
+    /// @param region The part of the score that is modified by this action.
+    void push(QUndoCommand *cmd, const DirtyRegion &region);
 
     void setClean();
 
+    /// Groups the following commands into a single undoable command. The
+    /// regions modified by the commands are merged, and the views are
+    /// updated once when the macro is finished.
     void beginMacro(const QString &text);
     void endMacro();
 
+    /// Sets the approximate amount of memory that the snapshots in each undo
+    /// stack may use. Once this is exceeded, the oldest snapshots are
+    /// discarded and those commands can no longer be undone.
+    void setMemoryBudget(size_t bytes);
+    /// Returns the approximate amount of memory used by the snapshots in the
+    /// active undo stack.
+    size_t getMemoryUsage() const;
+
+    /// Returns whether the active stack can be undone. Commands whose
+    /// snapshots have been discarded cannot be undone.
+    bool canUndo() const;
+    /// Undoes the active stack's most recent command, if possible.
+    void undo();
+
+    /// Creates an action that undoes the active stack, taking into account
+    /// any commands that can no longer be undone.
+    QAction *createUndoAction(QObject *parent,
+                              const QString &prefix = QString());
+
     static const int AFFECTS_ALL_SYSTEMS = -1;
+    static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
 
 signals:
     void fullRedrawNeeded();
     void redrawNeeded(int);
+    /// Emitted when an action only modified a single staff.
+    void staffRedrawNeeded(const DirtyRegion &region);
+    /// Emitted after a command is pushed, with the updated memory usage of
+    /// the active stack.
+    void memoryUsageChanged(size_t bytes);
 
 private:
     /// Pushes the QUndoCommand onto the active stack.
     void push(QUndoCommand *cmd);
 
-    void onSystemChanged(int affectedSystem);
+    void onRegionChanged(const DirtyRegion &region);
+
+    /// Starts a macro on the active stack. If the macro is for a single
+    /// command inside another macro, its region is redrawn along with the
+    /// enclosing macro.
+    void openMacro(const QString &text, bool isCommand);
+    /// Finishes the current macro, adding the commands that redraw its region
+    /// if necessary.
+    void closeMacro();
+    /// Adds the region to the region modified by the current macro.
+    void addDirtyRegion(const DirtyRegion &region);
+
+    /// The region modified by a macro that is in progress.
+    struct PendingRedraw
+    {
+        /// Triggers the redraw when the macro is undone, or null if the region
+        /// is redrawn by the enclosing macro.
+        SignalOnUndo *myOnUndo;
+        boost::optional<DirtyRegion> myRegion;
+    };
+
+    struct Snapshot
+    {
+        /// The stack's index once the command has been applied.
+        int myIndex;
+        SnapshotCommand *myCommand;
+        /// The memory that would be freed by discarding this snapshot.
+        size_t myMemoryUsage;
+    };
+
+    /// Tracks the memory used by an undo stack.
+    struct History
+    {
+        explicit History(const Score &score);
+
+        /// The score that the stack's commands modify.
+        const Score *myScore;
+        /// Snapshot commands in the stack, from oldest to newest.
+        std::deque<Snapshot> mySnapshots;
+        size_t myMemoryUsage;
+        /// The stack cannot be undone past this index, since the snapshots
+        /// for the earlier commands have been discarded.
+        int myMinIndex;
+    };
+
+    /// Returns the index of the stack in undoStacks, or -1.
+    int indexOfStack(const QUndoStack *stack) const;
+
+    /// Discards the oldest snapshots from the active stack until it is
+    /// within the memory budget.
+    void enforceMemoryBudget();
 
     std::vector<std::unique_ptr<QUndoStack>> undoStacks;
+    /// The history for each stack in undoStacks.
+    std::vector<History> myHistories;
+    size_t myMemoryBudget;
+    /// The macros that are in progress, from outermost to innermost.
+    std::vector<PendingRedraw> myPendingRedraws;
 };
 
 class SignalOnRedo : public QObject, public QUndoCommand
@@ -56,7 +56,10 @@ void Caret::moveHorizontal(int offset)
 
 void Caret::moveVertical(int offset)
 {
-    const int numStrings = myLocation.getStaff().getStringCount();
+    // Use the const accessors, since reading through the non-const ones would
+    // unshare the staff from any undo snapshots.
+    const ScoreLocation &location = myLocation;
+    const int numStrings = location.getStaff().getStringCount();
     myLocation.setString((myLocation.getString() + offset + numStrings) %
                          numStrings);
 
@@ -95,8 +98,9 @@ void Caret::moveStaff(int offset)
 
 void Caret::moveToStaff(int staff)
 {
+    const ScoreLocation &location = myLocation;
     const int num_staves =
-        static_cast<int>(myLocation.getSystem().getStaves().size());
+        static_cast<int>(location.getSystem().getStaves().size());
     staff = boost::algorithm::clamp(staff, 0, num_staves - 1);
 
     const bool is_increasing = staff >= myLocation.getStaffIndex();
@@ -200,9 +204,10 @@ bool Caret::moveToSystem(int system, bool keepStaff)
             myLocation.setStaffIndex(0);
         else
         {
+            const ScoreLocation &location = myLocation;
             myLocation.setStaffIndex(boost::algorithm::clamp(
-                myLocation.getStaffIndex(), 0,
-                static_cast<int>(myLocation.getSystem().getStaves().size() - 1)));
+                location.getStaffIndex(), 0,
+                static_cast<int>(location.getSystem().getStaves().size() - 1)));
         }
 
         myLocation.setPositionIndex(0);
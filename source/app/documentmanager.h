@@ -23,6 +23,7 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/optional/optional.hpp>
 #include <memory>
+#include <midi/midieventcache.h>
 #include <score/score.h>
 #include <vector>
 
@@ -54,11 +55,15 @@ public:
     const Caret &getCaret() const;
     Caret &getCaret();
 
+    /// Cached MIDI events from previous playback of the score.
+    MidiEventCache &getMidiEventCache() { return myMidiEventCache; }
+
 private:
     boost::optional<PathType> myFilename;
     Score myScore;
     ViewOptions myViewOptions;
     Caret myCaret;
+    MidiEventCache myMidiEventCache;
 };
 
 /// Class for managing open documents.
@@ -179,6 +179,8 @@ PowerTabEditor::PowerTabEditor()
             SLOT(redrawSystem(int)));
     connect(myUndoManager.get(), SIGNAL(fullRedrawNeeded()), this,
             SLOT(redrawScore()));
+    connect(myUndoManager.get(), &UndoManager::staffRedrawNeeded, this,
+            &PowerTabEditor::redrawStaff);
     connect(myUndoManager.get(), SIGNAL(cleanChanged(bool)), this,
             SLOT(updateModified(bool)));
 
@@ -590,8 +592,10 @@ void PowerTabEditor::startStopPlayback(bool from_measure_start)
 
         const ScoreLocation &location = getLocation();
         myMidiPlayer.reset(
-            new MidiPlayer(*mySettingsManager, location,
-                           myPlaybackWidget->getPlaybackSpeed()));
+            new MidiPlayer(*mySettingsManager,
+                           myDocumentManager->getCurrentDocument()
+                               .getMidiEventCache(),
+                           location, myPlaybackWidget->getPlaybackSpeed()));
 
         connect(myMidiPlayer.get(), SIGNAL(playbackSystemChanged(int)), this,
                 SLOT(moveCaretToSystem(int)));
@@ -629,15 +633,31 @@ void PowerTabEditor::startStopPlayback(bool from_measure_start)
 
 void PowerTabEditor::redrawSystem(int index)
 {
+    myDocumentManager->getCurrentDocument().getMidiEventCache().invalidateSystem(
+        index);
+    getScoreArea()->invalidateLayouts(index);
     getCaret().moveToValidPosition();
     getScoreArea()->redrawSystem(index);
     updateCommands();
 }
 
+void PowerTabEditor::redrawStaff(const DirtyRegion &region)
+{
+    myDocumentManager->getCurrentDocument().getMidiEventCache().invalidateSystem(
+        region.getSystemIndex());
+    getScoreArea()->invalidateLayouts(region.getSystemIndex());
+    getCaret().moveToValidPosition();
+    getScoreArea()->redrawStaff(region.getSystemIndex(),
+                                region.getStaffIndex());
+    updateCommands();
+}
+
 void PowerTabEditor::redrawScore()
 {
     Document &doc = myDocumentManager->getCurrentDocument();
     doc.validateViewOptions();
+    doc.getMidiEventCache().clear();
+    getScoreArea()->invalidateLayouts();
     getCaret().moveToValidPosition();
     getScoreArea()->renderDocument(doc);
     updateCommands();
@@ -759,7 +779,7 @@ void PowerTabEditor::removeCurrentPosition()
     else
     {
     	myUndoManager->push(new RemoveNote(location),
-    			location.getSystemIndex());
+    			DirtyRegion::fromLocation(location));
     }
 }
 
@@ -786,7 +806,7 @@ void PowerTabEditor::removeSelectedPositions()
     {
         location.setPositionIndex(position);
         myUndoManager->push(new RemovePosition(location),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
 
     std::vector<int> barPositions;
@@ -928,7 +948,7 @@ void PowerTabEditor::updateNoteDuration(Position::DurationType duration)
     {
         myUndoManager->push(
             new EditNoteDuration(getLocation(), duration, false),
-            getLocation().getSystemIndex());
+            DirtyRegion::fromLocation(getLocation()));
     }
     else
         updateCommands();
@@ -984,7 +1004,7 @@ void PowerTabEditor::changeNoteDuration(bool increase)
 
             myUndoManager->push(
                 new EditNoteDuration(location, new_duration, false),
-                location.getSystemIndex());
+                DirtyRegion::fromLocation(location));
         }
 
         myUndoManager->endMacro();
@@ -1002,14 +1022,14 @@ void PowerTabEditor::addDot()
         myUndoManager->push(new AddPositionProperty(
                                 location, Position::DoubleDotted,
                                 myDoubleDottedCommand->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
         myUndoManager->push(new AddPositionProperty(
                                 location, Position::Dotted,
                                 myDottedCommand->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
 }
 
@@ -1024,14 +1044,14 @@ void PowerTabEditor::removeDot()
         myUndoManager->push(new AddPositionProperty(
                                 location, Position::Dotted,
                                 myDottedCommand->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
         myUndoManager->push(new RemovePositionProperty(
                                 location, Position::Dotted,
                                 myDottedCommand->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
 }
 
@@ -1053,7 +1073,7 @@ void PowerTabEditor::editTiedNote()
             newNote.setProperty(Note::Tied);
             myUndoManager->push(
                 new AddNote(location, newNote, myActiveDurationType),
-                location.getSystemIndex());
+                DirtyRegion::fromLocation(location));
         }
         else
             myTieCommand->setChecked(false);
@@ -1109,7 +1129,7 @@ void PowerTabEditor::editIrregularGrouping(bool setAsTriplet)
         {
             myUndoManager->push(
                 new RemoveIrregularGrouping(location, *groups.back()),
-                location.getSystemIndex());
+                DirtyRegion::fromLocation(location));
         }
         return;
     }
@@ -1122,7 +1142,7 @@ void PowerTabEditor::editIrregularGrouping(bool setAsTriplet)
         if (setAsTriplet)
         {
             myUndoManager->push(new AddIrregularGrouping(location, group),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
         else
         {
@@ -1133,7 +1153,7 @@ void PowerTabEditor::editIrregularGrouping(bool setAsTriplet)
                 group.setNotesPlayed(dialog.getNotesPlayed());
                 group.setNotesPlayedOver(dialog.getNotesPlayedOver());
                 myUndoManager->push(new AddIrregularGrouping(location, group),
-                                    location.getSystemIndex());
+                                    DirtyRegion::fromLocation(location));
             }
         }
     }
@@ -1147,7 +1167,7 @@ void PowerTabEditor::addRest()
         pos ? pos->getDurationType() : myActiveDurationType;
 
     myUndoManager->push(new AddRest(location, duration),
-                        location.getSystemIndex());
+                        DirtyRegion::fromLocation(location));
 }
 
 void PowerTabEditor::editMultiBarRest()
@@ -1158,7 +1178,7 @@ void PowerTabEditor::editMultiBarRest()
     {
         myUndoManager->push(
             new RemovePosition(location, tr("Remove Multi-Bar Rest")),
-            location.getSystemIndex());
+            DirtyRegion::fromLocation(location));
     }
     else
     {
@@ -1192,7 +1212,7 @@ void PowerTabEditor::editMultiBarRest()
         {
             myUndoManager->push(
                 new AddMultiBarRest(location, dialog.getBarCount()),
-                location.getSystemIndex());
+                DirtyRegion::fromLocation(location));
         }
         else
             myMultibarRestCommand->setChecked(false);
@@ -1365,12 +1385,13 @@ void PowerTabEditor::editDynamic()
 {
     ScoreLocation &location = getLocation();
     const Dynamic *dynamic = ScoreUtils::findByPosition(
-                location.getStaff().getDynamics(), location.getPositionIndex());
+        const_cast<const ScoreLocation &>(location).getStaff().getDynamics(),
+        location.getPositionIndex());
 
     if (dynamic)
     {
         myUndoManager->push(new RemoveDynamic(location),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
@@ -1381,7 +1402,7 @@ void PowerTabEditor::editDynamic()
                             dialog.getVolumeLevel());
 
             myUndoManager->push(new AddDynamic(location, dynamic),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
         else
             myDynamicCommand->setChecked(false);
@@ -1416,7 +1437,7 @@ void PowerTabEditor::editArtificialHarmonic()
         {
             myUndoManager->push(
                 new AddArtificialHarmonic(location, dialog.getHarmonic()),
-                location.getSystemIndex());
+                DirtyRegion::fromLocation(location));
         }
         else
             myArtificialHarmonicCommand->setChecked(false);
@@ -1424,7 +1445,7 @@ void PowerTabEditor::editArtificialHarmonic()
     else
     {
         myUndoManager->push(new RemoveArtificialHarmonic(location),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
 }
 
@@ -1436,7 +1457,7 @@ void PowerTabEditor::editTappedHarmonic()
 
     if (note->hasTappedHarmonic())
         myUndoManager->push(new RemoveTappedHarmonic(location),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     else
     {
         TappedHarmonicDialog dialog(this, note->getFretNumber());
@@ -1444,7 +1465,7 @@ void PowerTabEditor::editTappedHarmonic()
         {
             myUndoManager->push(new AddTappedHarmonic(location,
                                                       dialog.getTappedFret()),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
         else
             myTappedHarmonicCommand->setChecked(false);
@@ -1460,7 +1481,7 @@ void PowerTabEditor::editBend()
     if (note->hasBend())
     {
         myUndoManager->push(new RemoveBend(location),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
@@ -1468,7 +1489,7 @@ void PowerTabEditor::editBend()
         if (dialog.exec() == QDialog::Accepted)
         {
             myUndoManager->push(new AddBend(location, dialog.getBend()),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
         else
             myBendCommand->setChecked(false);
@@ -1482,14 +1503,15 @@ void PowerTabEditor::editTrill()
     Q_ASSERT(note);
 
     if (note->hasTrill())
-        myUndoManager->push(new RemoveTrill(location), location.getSystemIndex());
+        myUndoManager->push(new RemoveTrill(location),
+                            DirtyRegion::fromLocation(location));
     else
     {
         TrillDialog dialog(this, note->getFretNumber());
         if (dialog.exec() == QDialog::Accepted)
         {
             myUndoManager->push(new AddTrill(location, dialog.getTrilledFret()),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
         else
             myTrillCommand->setChecked(false);
@@ -1505,7 +1527,7 @@ void PowerTabEditor::editLeftHandFingering()
     if (note->hasLeftHandFingering())
     {
         myUndoManager->push(new RemoveLeftHandFingering(location),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
@@ -1514,7 +1536,7 @@ void PowerTabEditor::editLeftHandFingering()
         {
             myUndoManager->push(new AddLeftHandFingering(location, 
                                 dialog.getLeftHandFingering()),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
         else
             myLeftHandFingeringCommand->setChecked(false);
@@ -1615,9 +1637,8 @@ void PowerTabEditor::editPlayerChange()
     {
         // Initialize the dialog with the current staves for each player.
         const PlayerChange *currentPlayers =
-                ScoreUtils::getCurrentPlayers(location.getScore(),
-                                              location.getSystemIndex(),
-                                              location.getPositionIndex());
+                location.getScore().getCurrentPlayers(
+                    location.getSystemIndex(), location.getPositionIndex());
 
         PlayerChangeDialog dialog(this, location.getScore(),
                                   location.getSystem(), currentPlayers);
@@ -1712,7 +1733,7 @@ bool PowerTabEditor::eventFilter(QObject *object, QEvent *event)
                 if (location.getNote())
                 {
                     myUndoManager->push(new EditTabNumber(location, number),
-                                        location.getSystemIndex());
+                                        DirtyRegion::fromLocation(location));
                 }
                 else
                 {
@@ -1720,7 +1741,7 @@ bool PowerTabEditor::eventFilter(QObject *object, QEvent *event)
                                 new AddNote(location,
                                             Note(location.getString(), number),
                                             myActiveDurationType),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
                 }
 
                 return true;
@@ -2946,6 +2967,20 @@ void PowerTabEditor::createTabArea()
     update_metronome_state();
     mySettingsManager->subscribeToChanges(update_metronome_state);
 
+    mySettingsManager->subscribeToChanges([&]() {
+        auto settings = mySettingsManager->getReadHandle();
+        const bool cache_images = settings->get(Settings::CacheSystemImages);
+
+        for (int i = 0; i < myTabWidget->count(); ++i)
+        {
+            if (auto scorearea =
+                    dynamic_cast<ScoreArea *>(myTabWidget->widget(i)))
+            {
+                scorearea->setImageCacheEnabled(cache_images);
+            }
+        }
+    });
+
     myPlaybackArea = new QWidget(this);
     QVBoxLayout *layout = new QVBoxLayout(myPlaybackArea);
     layout->addWidget(myTabWidget);
@@ -2981,6 +3016,11 @@ void PowerTabEditor::setupNewTab()
     });
 
     auto scorearea = new ScoreArea(this);
+    {
+        auto settings = mySettingsManager->getReadHandle();
+        scorearea->setImageCacheEnabled(
+            settings->get(Settings::CacheSystemImages));
+    }
     scorearea->renderDocument(doc);
     scorearea->installEventFilter(this);
 
@@ -3015,7 +3055,7 @@ void PowerTabEditor::setupNewTab()
         }
     });
 
-    myUndoManager->addNewUndoStack();
+    myUndoManager->addNewUndoStack(doc.getScore());
 
     QString filename = "Untitled";
     if (doc.hasFilename())
@@ -3082,7 +3122,8 @@ void PowerTabEditor::updateCommands()
     if (myIsPlaying)
         return;
 
-    ScoreLocation location = getLocation();
+    // Only use the const accessors, since this doesn't modify the score.
+    const ScoreLocation &location = getLocation();
     const Score &score = location.getScore();
     if (score.getSystems().empty())
         return;
@@ -3339,13 +3380,13 @@ void PowerTabEditor::editRest(Position::DurationType duration)
         else
         {
             myUndoManager->push(new EditNoteDuration(location, duration, true),
-                                location.getSystemIndex());
+                                DirtyRegion::fromLocation(location));
         }
     }
     else
     {
         myUndoManager->push(new AddRest(location, duration),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
 
     }
 }
@@ -3513,13 +3554,13 @@ void PowerTabEditor::editSimplePositionProperty(Command *command,
     {
         myUndoManager->push(new AddPositionProperty(location, property,
                                                     command->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
         myUndoManager->push(new RemovePositionProperty(location, property,
                                                        command->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
 }
 
@@ -3544,13 +3585,13 @@ void PowerTabEditor::editSimpleNoteProperty(Command *command,
     {
         myUndoManager->push(new AddNoteProperty(location, property,
                                                 command->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
     else
     {
         myUndoManager->push(new RemoveNoteProperty(location, property,
                                                    command->text()),
-                            location.getSystemIndex());
+                            DirtyRegion::fromLocation(location));
     }
 }
 
@@ -29,6 +29,7 @@
 
 class Caret;
 class Command;
+class DirtyRegion;
 class DocumentManager;
 class FileFormatManager;
 class InstrumentPanel;
@@ -121,6 +122,8 @@ private slots:
 
     /// Redraws only the given system.
     void redrawSystem(int);
+    /// Redraws only the staff containing the modified region.
+    void redrawStaff(const DirtyRegion &region);
     /// Redraws the entire score.
     void redrawScore();
 
@@ -18,20 +18,38 @@
 #include "scorearea.h"
 
 #include <app/documentmanager.h>
+#include <algorithm>
 #include <app/pubsub/clickpubsub.h>
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <painters/caretpainter.h>
+#include <painters/layoutcache.h>
 #include <painters/scoreinforenderer.h>
 #include <painters/systemrenderer.h>
+#include <painters/systemtile.h>
 #include <QDebug>
 #include <QGraphicsItem>
 #include <QGraphicsSceneDragDropEvent>
 #include <QPrinter>
 #include <QScrollBar>
 #include <score/score.h>
+#include <thread>
 
 static const double SYSTEM_SPACING = 50;
+/// Space to the left and right of the systems (e.g. for bar numbers).
+static const double SYSTEM_MARGIN = 30;
+/// Systems within this many screen heights of the visible area are rendered
+/// before they are scrolled into view.
+static const double PREFETCH_SCREENS = 1;
+/// Rendered systems that are further than this many screen heights from the
+/// visible area are released.
+static const double RELEASE_SCREENS = 3;
+/// Systems that would have a larger image than this are not cached.
+static const double MAX_IMAGE_SIZE = 8192;
+/// How often to check for images that have finished rendering, in
+/// milliseconds.
+static const int IMAGE_POLL_INTERVAL = 15;
 
 void ScoreArea::Scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 {
@@ -42,124 +60,405 @@ ScoreArea::ScoreArea(QWidget *parent)
     : QGraphicsView(parent),
       myScoreInfoBlock(nullptr),
       myCaretPainter(nullptr),
+      myIsUpdatingSystems(false),
+      myImageCacheEnabled(false),
+      myNextImageRequestId(1),
       myClickPubSub(std::make_shared<ClickPubSub>())
 {
     setScene(&myScene);
+
+    myImageTimer.setInterval(IMAGE_POLL_INTERVAL);
+    connect(&myImageTimer, &QTimer::timeout, this,
+            [=]() { updateSystemImages(); });
 }
 
 void ScoreArea::renderDocument(const Document &document)
 {
     myScene.clear();
     myRenderedSystems.clear();
+    myRenderedStaves.clear();
+    myRenderedLayouts.clear();
+    mySystemTops.clear();
+    mySystemHeights.clear();
+    mySystemTiles.clear();
+    myImageRequestIds.clear();
+    myQueuedImages.clear();
     myDocument = document;
 
     const Score &score = document.getScore();
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    myCaretPainter =
-        new CaretPainter(document.getCaret(), document.getViewOptions());
+    myLayoutCache =
+        std::make_shared<LayoutCache>(score, document.getViewOptions());
+    myCaretPainter = new CaretPainter(document.getCaret(), myLayoutCache);
     myCaretPainter->subscribeToMovement([=]() {
-        adjustScroll();
+        // Don't jump back to the caret when it only moved because systems
+        // were rendered while scrolling.
+        if (!myIsUpdatingSystems)
+            adjustScroll();
     });
 
     myScoreInfoBlock = ScoreInfoRenderer::render(score.getScoreInfo());
+    myScene.addItem(myScoreInfoBlock);
 
-    myRenderedSystems.reserve(score.getSystems().size());
-    for (unsigned int i = 0; i < score.getSystems().size(); ++i)
+    // Only estimate the height of each system for now. The systems are
+    // rendered once they are close to being scrolled into view.
+    const int num_systems = static_cast<int>(score.getSystems().size());
+    for (int i = 0; i < num_systems; ++i)
+    {
         myRenderedSystems.append(nullptr);
+        mySystemHeights.push_back(SystemRenderer::estimateHeight(
+            score, score.getSystems()[i], i, document.getViewOptions()));
+        myCaretPainter->addSystemRect(QRectF());
+    }
+
+    mySystemTops.resize(num_systems);
+    myRenderedStaves.resize(num_systems);
+    myRenderedLayouts.resize(num_systems);
+    mySystemTiles.resize(num_systems, nullptr);
+    myImageRequestIds.resize(num_systems, 0);
+
+    layoutSystems(0);
+    myScene.addItem(myCaretPainter);
+    updateVisibleSystems();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    qDebug() << "Score rendered in"
+             << std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end - start).count() << "ms";
+    qDebug() << "Rendered " << myScene.items().size() << "items";
+}
+
+void ScoreArea::redrawSystem(int index)
+{
+    const Score &score = myDocument->getScore();
+
+    // If the system hasn't been rendered, only its height needs to be updated.
+    if (!myRenderedSystems[index])
+    {
+        mySystemHeights[index] = SystemRenderer::estimateHeight(
+            score, score.getSystems()[index], index,
+            myDocument->getViewOptions());
+        myLayoutCache->invalidate(index);
+        layoutSystems(index);
+        myCaretPainter->updatePosition();
+        updateVisibleSystems();
+        return;
+    }
+
+    redrawSystem(index, SystemRenderer::computeLayouts(
+                            score, score.getSystems()[index], index,
+                            myDocument->getViewOptions()));
+}
+
+void ScoreArea::redrawStaff(int systemIndex, int staffIndex)
+{
+    const Score &score = myDocument->getScore();
+    const System &system = score.getSystems()[systemIndex];
+
+    if (!myRenderedSystems[systemIndex] ||
+        myRenderedStaves[systemIndex].size() != system.getStaves().size())
+    {
+        redrawSystem(systemIndex);
+        return;
+    }
+
+    std::vector<LayoutConstPtr> layouts = myRenderedLayouts[systemIndex];
+
+    const LayoutConstPtr oldLayout = layouts[staffIndex];
+    const LayoutConstPtr newLayout = SystemRenderer::computeLayout(
+        score, system, systemIndex, staffIndex, myDocument->getViewOptions());
+    layouts[staffIndex] = newLayout;
+
+    // If the staff is hidden by the view filter, there is nothing to draw.
+    if (!oldLayout && !newLayout)
+        return;
+
+    // If the number of positions in the system changed, the spacing of every
+    // staff is different.
+    if (!oldLayout || !newLayout ||
+        oldLayout->getNumPositions() != newLayout->getNumPositions())
+    {
+        redrawSystem(systemIndex);
+        return;
+    }
+
+    // The other layouts can be reused if they still refer to the current
+    // staves. The staves are copied when they are modified while shared with
+    // an undo snapshot, in which case their layouts need to be recomputed.
+    bool otherStavesChanged = false;
+    for (size_t i = 0; i < layouts.size(); ++i)
+    {
+        const LayoutConstPtr &layout = layouts[i];
+        if (static_cast<int>(i) == staffIndex || !layout ||
+            layout->isCurrent(system, static_cast<int>(i)))
+        {
+            continue;
+        }
+
+        layouts[i] = SystemRenderer::computeLayout(
+            score, system, systemIndex, static_cast<int>(i),
+            myDocument->getViewOptions());
+        otherStavesChanged = true;
+    }
+
+    // Redraw the whole system if any other staff needs to be redrawn, or if
+    // the staff's height changed and the following staves need to be moved.
+    QGraphicsItem *oldItem = myRenderedStaves[systemIndex][staffIndex];
+    if (otherStavesChanged || !oldItem ||
+        oldLayout->getStaffHeight() != newLayout->getStaffHeight())
+    {
+        redrawSystem(systemIndex, layouts);
+        return;
+    }
+
+    auto firstVisible = std::find_if(
+        layouts.begin(), layouts.end(),
+        [](const LayoutConstPtr &layout) { return layout != nullptr; });
+    const bool isFirstStaff = (firstVisible - layouts.begin()) == staffIndex;
+
+    SystemRenderer render(this, score, myDocument->getViewOptions());
+    QGraphicsItem *newItem = render.drawStaff(system, systemIndex, staffIndex,
+                                              newLayout, isFirstStaff);
+    newItem->setPos(oldItem->pos());
+    newItem->setParentItem(oldItem->parentItem());
+    delete oldItem;
+
+    myRenderedStaves[systemIndex][staffIndex] = newItem;
+    myRenderedLayouts[systemIndex] = layouts;
+    myLayoutCache->setLayouts(systemIndex, std::move(layouts));
 
-#if 0
-    const int num_threads = std::thread::hardware_concurrency();
-#else
-    const int num_threads = 1;
-#endif
+    createSystemImage(systemIndex);
+    myCaretPainter->updatePosition();
+}
+
+void ScoreArea::redrawSystem(int index,
+                             const std::vector<LayoutConstPtr> &layouts)
+{
+    // Delete and remove the system from the scene.
+    removeSystemImage(index);
+    delete myRenderedSystems[index];
+
+    const Score &score = myDocument->getScore();
+    SystemRenderer render(this, score, myDocument->getViewOptions());
+    QGraphicsItem *newSystem = render(score.getSystems()[index], index,
+                                      layouts);
+    myScene.addItem(newSystem);
+    myRenderedSystems[index] = newSystem;
+    myRenderedStaves[index] = render.getStaffItems();
+    myRenderedLayouts[index] = layouts;
+    myLayoutCache->setLayouts(index, layouts);
+    mySystemHeights[index] = newSystem->boundingRect().height();
+    createSystemImage(index);
+
+    // Shift the following systems.
+    layoutSystems(index);
+
+    // The spacing may have changed, so update the caret's position and redraw
+    // it.
+    myCaretPainter->updatePosition();
+
+    // If the system became smaller, other systems may now be visible.
+    updateVisibleSystems();
+}
+
+void ScoreArea::renderSystems(const std::vector<int> &indices)
+{
+    const Score &score = myDocument->getScore();
+    const ViewOptions &view_options = myDocument->getViewOptions();
+
+    // First, compute the layout of every system in parallel. This doesn't
+    // create any QGraphicsItems, so it is safe to do off the GUI thread.
+    const int num_systems = static_cast<int>(indices.size());
+    std::vector<std::vector<LayoutConstPtr>> layouts(num_systems);
+    std::vector<int> uncached_systems;
+    for (int i = 0; i < num_systems; ++i)
+    {
+        // The layouts may have already been computed for the caret.
+        if (myLayoutCache->contains(indices[i]))
+            layouts[i] = myLayoutCache->getLayouts(indices[i]);
+        else
+            uncached_systems.push_back(i);
+    }
+
+    const int num_uncached = static_cast<int>(uncached_systems.size());
+    const int num_threads = std::min(
+        std::max<int>(1, std::thread::hardware_concurrency()), num_uncached);
+
+    std::atomic<int> next_system(0);
     std::vector<std::future<void>> tasks;
-    const int work_size = myRenderedSystems.size() / num_threads;
-    qDebug() << "Using" << num_threads << "worker thread(s)";
 
     for (int i = 0; i < num_threads; ++i)
     {
-        const int left = i * work_size;
-        const int right = (i == num_threads - 1) ? myRenderedSystems.size()
-                                                 : (i + 1) * work_size;
-
-        tasks.push_back(std::async(std::launch::async, [&](int left, int right)
+        tasks.push_back(std::async(std::launch::async, [&]()
         {
-            for (int i = left; i < right; ++i)
+            int k;
+            while ((k = next_system++) < num_uncached)
             {
-                SystemRenderer render(this, score, document.getViewOptions());
-                myRenderedSystems[i] = render(score.getSystems()[i], i);
+                const int j = uncached_systems[k];
+                const int system_index = indices[j];
+                layouts[j] = SystemRenderer::computeLayouts(
+                    score, score.getSystems()[system_index], system_index,
+                    view_options);
             }
-        }, left, right));
+        }));
     }
 
     for (auto &&task : tasks)
         task.get();
 
-    double height = 0;
-    // Score info.
-    myScene.addItem(myScoreInfoBlock);
-    height += myScoreInfoBlock->boundingRect().height() + 0.5 * SYSTEM_SPACING;
-
-    // Layout the systems.
-    for (QGraphicsItem *system : myRenderedSystems)
+    // Then, build the graphics items on the GUI thread.
+    for (int i = 0; i < num_systems; ++i)
     {
-        system->setPos(0, height);
+        const int system_index = indices[i];
+
+        SystemRenderer render(this, score, view_options);
+        QGraphicsItem *system =
+            render(score.getSystems()[system_index], system_index, layouts[i]);
         myScene.addItem(system);
-        height += system->boundingRect().height() + SYSTEM_SPACING;
 
-        myCaretPainter->addSystemRect(system->sceneBoundingRect());
+        myRenderedSystems[system_index] = system;
+        myRenderedStaves[system_index] = render.getStaffItems();
+        myRenderedLayouts[system_index] = layouts[i];
+        myLayoutCache->setLayouts(system_index, std::move(layouts[i]));
+        mySystemHeights[system_index] = system->boundingRect().height();
+        createSystemImage(system_index);
     }
 
-    myScene.addItem(myCaretPainter);
+    // The estimated heights may have been inaccurate, so shift the systems
+    // as necessary.
+    layoutSystems(*std::min_element(indices.begin(), indices.end()));
+}
 
-    auto end = std::chrono::high_resolution_clock::now();
-    qDebug() << "Score rendered in"
-             << std::chrono::duration_cast<std::chrono::milliseconds>(
-                    end - start).count() << "ms";
-    qDebug() << "Rendered " << myScene.items().size() << "items";
+void ScoreArea::releaseSystem(int index)
+{
+    // The system's height is still known, so it can be placed correctly if
+    // it is rendered again later.
+    removeSystemImage(index);
+    delete myRenderedSystems[index];
+    myRenderedSystems[index] = nullptr;
+    myRenderedStaves[index].clear();
+    myRenderedLayouts[index].clear();
+    myLayoutCache->invalidate(index);
 }
 
-void ScoreArea::redrawSystem(int index)
+void ScoreArea::invalidateLayouts(int systemIndex)
 {
-    // Delete and remove the system from the scene.
-    delete myRenderedSystems.takeAt(index);
+    myLayoutCache->invalidate(systemIndex);
+}
 
-    const Score &score = myDocument->getScore();
-    SystemRenderer render(this, score, myDocument->getViewOptions());
-    QGraphicsItem *newSystem = render(score.getSystems()[index], index);
+void ScoreArea::invalidateLayouts()
+{
+    myLayoutCache->clear();
+}
 
-    double height = 0;
-    if (index > 0)
+void ScoreArea::layoutSystems(int firstIndex)
+{
+    double top = 0;
+    if (firstIndex > 0)
     {
-        height = myRenderedSystems.at(index - 1)->sceneBoundingRect().bottom() +
-                SYSTEM_SPACING;
+        top = mySystemTops[firstIndex - 1] + mySystemHeights[firstIndex - 1] +
+              SYSTEM_SPACING;
     }
+    else
+        top = myScoreInfoBlock->boundingRect().height() + 0.5 * SYSTEM_SPACING;
 
-    newSystem->setPos(0, height);
-    height += newSystem->boundingRect().height() + SYSTEM_SPACING;
-    myCaretPainter->setSystemRect(index, newSystem->sceneBoundingRect());
+    for (int i = firstIndex; i < myRenderedSystems.size(); ++i)
+    {
+        mySystemTops[i] = top;
 
-    myScene.addItem(newSystem);
-    myRenderedSystems.insert(index, newSystem);
+        if (QGraphicsItem *system = myRenderedSystems[i])
+        {
+            system->setPos(0, top);
+            myCaretPainter->setSystemRect(i, system->sceneBoundingRect());
 
-    // Shift the following systems.
-    for (int i = index + 1; i < myRenderedSystems.size(); ++i)
+            if (SystemTile *tile = mySystemTiles[i])
+                tile->setPos(0, top);
+        }
+        else
+        {
+            myCaretPainter->setSystemRect(
+                i, QRectF(0, top, LayoutInfo::STAFF_WIDTH, mySystemHeights[i]));
+        }
+
+        top += mySystemHeights[i] + SYSTEM_SPACING;
+    }
+
+    // Most of the systems don't have any items in the scene, so the scene's
+    // size needs to be set explicitly.
+    myScene.setSceneRect(myScoreInfoBlock->sceneBoundingRect().united(
+        QRectF(-SYSTEM_MARGIN, 0, LayoutInfo::STAFF_WIDTH + 2 * SYSTEM_MARGIN,
+               top)));
+}
+
+void ScoreArea::updateVisibleSystems()
+{
+    if (!myDocument || myIsUpdatingSystems)
+        return;
+
+    myIsUpdatingSystems = true;
+
+    // Rendering systems can change the heights of the systems above the
+    // visible area, which in turn can bring new systems into view.
+    while (true)
     {
-        QGraphicsItem *system = myRenderedSystems[i];
-        system->setPos(0, height);
-        height += system->boundingRect().height() + SYSTEM_SPACING;
-        myCaretPainter->setSystemRect(i, system->sceneBoundingRect());
+        const QRectF visible = mapToScene(viewport()->rect()).boundingRect();
+        const double prefetch_top =
+            visible.top() - PREFETCH_SCREENS * visible.height();
+        const double prefetch_bottom =
+            visible.bottom() + PREFETCH_SCREENS * visible.height();
+        const double release_top =
+            visible.top() - RELEASE_SCREENS * visible.height();
+        const double release_bottom =
+            visible.bottom() + RELEASE_SCREENS * visible.height();
+
+        std::vector<int> new_systems;
+        int anchor = -1;
+        for (int i = 0; i < myRenderedSystems.size(); ++i)
+        {
+            const double top = mySystemTops[i];
+            const double bottom = top + mySystemHeights[i];
+
+            if (anchor < 0 && bottom >= visible.top())
+                anchor = i;
+
+            if (!myRenderedSystems[i])
+            {
+                if (bottom >= prefetch_top && top <= prefetch_bottom)
+                    new_systems.push_back(i);
+            }
+            else if (bottom < release_top || top > release_bottom)
+                releaseSystem(i);
+        }
+
+        if (new_systems.empty())
+            break;
+
+        const double anchor_top = (anchor >= 0) ? mySystemTops[anchor] : 0;
+        renderSystems(new_systems);
+
+        // Keep the visible systems in place if the systems above them turned
+        // out to have a different height than was estimated.
+        if (anchor >= 0 && mySystemTops[anchor] != anchor_top)
+        {
+            const double offset =
+                (mySystemTops[anchor] - anchor_top) * transform().m22();
+            verticalScrollBar()->setValue(verticalScrollBar()->value() +
+                                          qRound(offset));
+        }
+
+        myCaretPainter->updatePosition();
     }
 
-    // The spacing may have changed, so update the caret's position and redraw
-    // it.
-    myCaretPainter->updatePosition();
+    myIsUpdatingSystems = false;
 }
 
 void ScoreArea::print(QPrinter &printer)
 {
+    // Avoid rendering or releasing systems in the middle of printing.
+    myIsUpdatingSystems = true;
+
     QPainter painter;
     painter.begin(&printer);
 
@@ -168,14 +467,26 @@ void ScoreArea::print(QPrinter &printer)
 
     QRectF target_rect(0, 0, painter.device()->width(),
                        painter.device()->height());
+    double prev_bottom = 0;
 
-    QList<QGraphicsItem*> items;
-    items.append(myScoreInfoBlock);
-    items.append(myRenderedSystems);
-
-    for (int i = 0, n = items.length(); i < n; ++i)
+    // The first item is the score information, followed by the systems.
+    for (int i = 0, n = myRenderedSystems.size() + 1; i < n; ++i)
     {
-        const QGraphicsItem *item = items[i];
+        const int system_index = i - 1;
+
+        // Systems that aren't in view are rendered temporarily.
+        const bool temporary =
+            (system_index >= 0 && !myRenderedSystems[system_index]);
+        if (temporary)
+            renderSystems({ system_index });
+
+        // Print the system's items rather than its pre-rendered image.
+        if (system_index >= 0)
+            showSystemImage(system_index, false);
+
+        const QGraphicsItem *item = (system_index >= 0)
+                                        ? myRenderedSystems[system_index]
+                                        : myScoreInfoBlock;
 
         const QRectF source_rect = item->sceneBoundingRect();
         const float ratio =
@@ -184,9 +495,7 @@ void ScoreArea::print(QPrinter &printer)
 
         if (i > 0)
         {
-            const QGraphicsItem *prev_item = items[i - 1];
-            const double spacing =
-                source_rect.y() - prev_item->sceneBoundingRect().bottom();
+            const double spacing = source_rect.y() - prev_bottom;
             target_rect.moveTop(target_rect.y() + spacing * ratio);
         }
 
@@ -204,10 +513,22 @@ void ScoreArea::print(QPrinter &printer)
 
         // Set the location for the next item.
         target_rect.moveTop(target_rect.y() + height);
+        prev_bottom = source_rect.bottom();
+
+        if (temporary)
+            releaseSystem(system_index);
     }
 
     myCaretPainter->show();
     painter.end();
+
+    for (int i = 0; i < myRenderedSystems.size(); ++i)
+        showSystemImage(i, true);
+
+    // Rendering the systems may have corrected their estimated heights.
+    myCaretPainter->updatePosition();
+    myIsUpdatingSystems = false;
+    updateVisibleSystems();
 }
 
 std::shared_ptr<ClickPubSub> ScoreArea::getClickPubSub() const
@@ -245,4 +566,166 @@ void ScoreArea::refreshZoom()
     QTransform xform;
     xform.scale(scale_factor, scale_factor);
     setTransform(xform);
+
+    // Draw the systems' items until the images for the new zoom level are
+    // ready.
+    for (int i = 0; i < static_cast<int>(mySystemTiles.size()); ++i)
+    {
+        if (mySystemTiles[i])
+        {
+            showSystemImage(i, false);
+            requestSystemImage(i);
+        }
+    }
+
+    updateVisibleSystems();
+}
+
+void ScoreArea::setImageCacheEnabled(bool enabled)
+{
+    if (enabled == myImageCacheEnabled)
+        return;
+
+    myImageCacheEnabled = enabled;
+
+    for (int i = 0; i < myRenderedSystems.size(); ++i)
+    {
+        if (enabled)
+            createSystemImage(i);
+        else
+            removeSystemImage(i);
+    }
+}
+
+void ScoreArea::createSystemImage(int index)
+{
+    removeSystemImage(index);
+
+    QGraphicsItem *system = myRenderedSystems[index];
+    if (!myImageCacheEnabled || !system)
+        return;
+
+    auto tile = new SystemTile(*system);
+    tile->setPos(system->pos());
+    tile->hide();
+    myScene.addItem(tile);
+    mySystemTiles[index] = tile;
+
+    requestSystemImage(index);
+}
+
+void ScoreArea::requestSystemImage(int index)
+{
+    const SystemTile *tile = mySystemTiles[index];
+
+    ImageRequest request;
+    request.mySystem = index;
+    request.myId = myNextImageRequestId++;
+    request.myScale = transform().m11();
+    request.myRect = tile->getPictureRect();
+    request.myPixelRatio = viewport()->devicePixelRatio();
+
+    // Very large images would use too much memory, so just draw the system's
+    // items instead.
+    const double pixel_scale = request.myScale * request.myPixelRatio;
+    if (request.myRect.width() * pixel_scale > MAX_IMAGE_SIZE ||
+        request.myRect.height() * pixel_scale > MAX_IMAGE_SIZE)
+    {
+        myImageRequestIds[index] = 0;
+        return;
+    }
+
+    myImageRequestIds[index] = request.myId;
+    myQueuedImages.push_back(std::move(request));
+
+    if (!myImageTimer.isActive())
+        myImageTimer.start();
+}
+
+void ScoreArea::removeSystemImage(int index)
+{
+    showSystemImage(index, false);
+
+    delete mySystemTiles[index];
+    mySystemTiles[index] = nullptr;
+    myImageRequestIds[index] = 0;
+}
+
+void ScoreArea::showSystemImage(int index, bool show)
+{
+    SystemTile *tile = mySystemTiles[index];
+    if (!tile)
+        return;
+
+    show = show && tile->hasImage();
+    tile->setVisible(show);
+
+    // The system's items are made transparent rather than hidden, so that
+    // they still receive mouse events.
+    if (QGraphicsItem *system = myRenderedSystems[index])
+        system->setOpacity(show ? 0 : 1);
+}
+
+void ScoreArea::updateSystemImages()
+{
+    // Display the images that have finished rendering, unless a newer image
+    // has been requested.
+    for (auto it = myRunningImages.begin(); it != myRunningImages.end();)
+    {
+        if (it->myImage.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        const QImage image = it->myImage.get();
+        const int index = it->mySystem;
+        if (index < static_cast<int>(myImageRequestIds.size()) &&
+            myImageRequestIds[index] == it->myId)
+        {
+            myImageRequestIds[index] = 0;
+            mySystemTiles[index]->setImage(image, it->myScale);
+            showSystemImage(index, true);
+        }
+
+        it = myRunningImages.erase(it);
+    }
+
+    // Start rendering the queued images, skipping any that are out of date.
+    const size_t max_threads =
+        std::max(1u, std::thread::hardware_concurrency());
+    while (!myQueuedImages.empty() && myRunningImages.size() < max_threads)
+    {
+        ImageRequest request = std::move(myQueuedImages.front());
+        myQueuedImages.pop_front();
+
+        if (request.mySystem >= static_cast<int>(myImageRequestIds.size()) ||
+            myImageRequestIds[request.mySystem] != request.myId)
+        {
+            continue;
+        }
+
+        // The system is recorded once its first image is actually needed.
+        request.myImage = std::async(
+            std::launch::async, &SystemTile::rasterize,
+            mySystemTiles[request.mySystem]->getPicture(), request.myRect,
+            request.myScale, request.myPixelRatio);
+        myRunningImages.push_back(std::move(request));
+    }
+
+    if (myQueuedImages.empty() && myRunningImages.empty())
+        myImageTimer.stop();
+}
+
+void ScoreArea::resizeEvent(QResizeEvent *event)
+{
+    QGraphicsView::resizeEvent(event);
+    updateVisibleSystems();
+}
+
+void ScoreArea::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+    updateVisibleSystems();
 }
@@ -19,17 +19,25 @@
 #define APP_SCOREAREA_H
 
 #include <boost/optional.hpp>
+#include <deque>
+#include <future>
 #include <memory>
+#include <painters/layoutinfo.h>
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <QTimer>
 #include <score/staff.h>
+#include <vector>
 
 class CaretPainter;
 class ClickPubSub;
 class Document;
+class LayoutCache;
 class QPrinter;
+class SystemTile;
 
-/// The visual display of the score.
+/// The visual display of the score. Only the systems that are near the visible
+/// part of the score are rendered.
 class ScoreArea : public QGraphicsView
 {
     class Scene : public QGraphicsScene
@@ -46,6 +54,11 @@ public:
 
     void renderDocument(const Document &document);
 
+    /// Enables or disables displaying pre-rendered images of the systems,
+    /// which are much faster to repaint when scrolling than the systems'
+    /// items.
+    void setImageCacheEnabled(bool enabled);
+
     void refreshZoom();
 
     void print(QPrinter &printer);
@@ -54,21 +67,100 @@ public:
     /// necessary.
     void redrawSystem(int index);
 
+    /// Redraws a single staff after its contents were modified. The layouts
+    /// and graphics items of the system's other staves are reused when
+    /// possible.
+    void redrawStaff(int systemIndex, int staffIndex);
+
+    /// Discards the cached layouts of a system as soon as it is modified,
+    /// since the caret may use them before the system is redrawn.
+    void invalidateLayouts(int systemIndex);
+    /// Discards the cached layouts of every system.
+    void invalidateLayouts();
+
     std::shared_ptr<ClickPubSub> getClickPubSub() const;
 
 protected:
     virtual void focusInEvent(QFocusEvent *event) override;
     virtual void focusOutEvent(QFocusEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
+    virtual void scrollContentsBy(int dx, int dy) override;
 
 private:
     /// Adjusts the scroll location whenever the caret moves.
     void adjustScroll();
 
+    /// Redraws the system using the given staff layouts.
+    void redrawSystem(int index, const std::vector<LayoutConstPtr> &layouts);
+
+    /// Creates the graphics items for the given systems.
+    void renderSystems(const std::vector<int> &indices);
+    /// Removes a system's graphics items from the scene.
+    void releaseSystem(int index);
+    /// Positions the systems, starting from the given system, based on the
+    /// heights of the previous systems.
+    void layoutSystems(int firstIndex);
+    /// Renders the systems that are near the visible area, and releases the
+    /// systems that are far away from it.
+    void updateVisibleSystems();
+
+    /// Records the system's items and starts rendering an image of the
+    /// system in the background, if the image cache is enabled.
+    void createSystemImage(int index);
+    /// Starts rendering a new image of the system for the current zoom level.
+    void requestSystemImage(int index);
+    /// Removes the image of the system.
+    void removeSystemImage(int index);
+    /// Switches between displaying the system's image and its items.
+    void showSystemImage(int index, bool show);
+    /// Starts any queued image requests, and displays the images that have
+    /// finished rendering.
+    void updateSystemImages();
+
     Scene myScene;
     boost::optional<const Document &> myDocument;
     QGraphicsItem *myScoreInfoBlock;
+    /// The graphics item for each system, or null if the system is not
+    /// currently rendered.
     QList<QGraphicsItem *> myRenderedSystems;
+    /// The top of each system in the scene.
+    std::vector<double> mySystemTops;
+    /// The height of each system. This is an estimate for systems that have
+    /// never been rendered.
+    std::vector<double> mySystemHeights;
+    /// The layout of each staff in the rendered systems, which is shared with
+    /// the caret.
+    std::shared_ptr<LayoutCache> myLayoutCache;
+    /// The graphics item for each staff in each rendered system.
+    std::vector<std::vector<QGraphicsItem *>> myRenderedStaves;
+    /// The layouts that each rendered system was drawn with, which may no
+    /// longer be in the layout cache if the system was since modified.
+    std::vector<std::vector<LayoutConstPtr>> myRenderedLayouts;
     CaretPainter *myCaretPainter;
+    /// Set while systems are being rendered or released, to avoid reentrancy
+    /// from scrolling or from moving the caret.
+    bool myIsUpdatingSystems;
+
+    struct ImageRequest
+    {
+        int mySystem;
+        int myId;
+        double myScale;
+        QRectF myRect;
+        double myPixelRatio;
+        std::future<QImage> myImage;
+    };
+
+    bool myImageCacheEnabled;
+    /// The pre-rendered image for each rendered system, if any.
+    std::vector<SystemTile *> mySystemTiles;
+    /// The most recent image request for each system, or 0 if there is none.
+    std::vector<int> myImageRequestIds;
+    int myNextImageRequestId;
+    std::deque<ImageRequest> myQueuedImages;
+    std::vector<ImageRequest> myRunningImages;
+    /// Polls for finished images while there are any requests.
+    QTimer myImageTimer;
 
     std::shared_ptr<ClickPubSub> myClickPubSub;
 };
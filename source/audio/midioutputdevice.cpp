@@ -17,6 +17,7 @@
   
 #include "midioutputdevice.h"
 
+#include <midi/midievent.h>
 #include <RtMidi.h>
 #include <score/dynamic.h>
 #include <score/generalmidi.h>
@@ -52,10 +53,22 @@ MidiOutputDevice::~MidiOutputDevice()
 }
 
 void
-MidiOutputDevice::sendMessage(const std::vector<uint8_t> &data)
+MidiOutputDevice::sendMessage(const uint8_t *data, size_t size)
 {
-    // FIXME - fix const correctness in RtMidi api.
-    myMidiOut->sendMessage(const_cast<std::vector<uint8_t> *>(&data));
+    myMessage.assign(data, data + size);
+    myMidiOut->sendMessage(&myMessage);
+}
+
+void MidiOutputDevice::sendMessages(const MidiEvent *const *events,
+                                    size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const MidiEvent &event = *events[i];
+        myMessage.assign(event.getData(),
+                         event.getData() + event.getDataSize());
+        myMidiOut->sendMessage(&myMessage);
+    }
 }
 
 bool MidiOutputDevice::sendMidiMessage(unsigned char a, unsigned char b,
@@ -30,6 +30,7 @@
 #include <memory>
 #include <vector>
 
+class MidiEvent;
 class RtMidiOut;
 
 class MidiOutputDevice
@@ -82,13 +83,18 @@ public:
         RpnMsb = 101
     };
 
-    void sendMessage(const std::vector<uint8_t> &data);
+    /// Sends a message, which includes the status byte.
+    void sendMessage(const uint8_t *data, size_t size);
+    /// Sends a group of events that occur at the same time.
+    void sendMessages(const MidiEvent *const *events, size_t count);
 
 private:
     bool sendMidiMessage(unsigned char a, unsigned char b, unsigned char c);
 
     std::vector<std::unique_ptr<RtMidiOut>> myMidiOuts;
     RtMidiOut *myMidiOut;
+    /// Reused for each message, to avoid allocating a new buffer.
+    std::vector<uint8_t> myMessage;
     /// Maximum volume for each channel (as set in the mixer).
     std::array<uint8_t, NUM_CHANNELS> myMaxVolumes;
     /// Volume of last active dynamic for each channel.
@@ -20,10 +20,12 @@
 #include <app/settingsmanager.h>
 #include <audio/midioutputdevice.h>
 #include <audio/settings.h>
-#include <boost/rational.hpp>
-#include <cassert>
 #include <chrono>
+#include <midi/midieventcache.h>
 #include <midi/midifile.h>
+#include <memory>
+#include <midi/miditimeline.h>
+#include <midi/playbackclock.h>
 #include <score/generalmidi.h>
 #include <score/score.h>
 #include <thread>
@@ -34,17 +36,28 @@
 #endif
 
 static const int METRONOME_CHANNEL = 9;
+/// Interval for checking for position changes from the playback thread.
+static const int POSITION_UPDATE_INTERVAL_MS = 10;
 
 using DurationType = std::chrono::duration<int, std::micro>;
 
 MidiPlayer::MidiPlayer(SettingsManager &settings_manager,
+                       MidiEventCache &event_cache,
                        const ScoreLocation &start_location, int speed)
     : mySettingsManager(settings_manager),
+      myEventCache(event_cache),
       myScore(start_location.getScore()),
       myStartLocation(start_location),
       myIsPlaying(false),
       myPlaybackSpeed(speed)
 {
+    // Deliver any remaining position changes before listeners are notified
+    // that playback finished.
+    connect(this, &QThread::finished, this, &MidiPlayer::emitPositionChanges);
+
+    connect(&myPositionTimer, &QTimer::timeout, this,
+            &MidiPlayer::emitPositionChanges);
+    myPositionTimer.start(POSITION_UPDATE_INTERVAL_MS);
 }
 
 MidiPlayer::~MidiPlayer()
@@ -96,24 +109,25 @@ void MidiPlayer::run()
             settings->get(Settings::MidiWideVibratoLevel);
     }
 
-    MidiFile file;
-    file.load(myScore, options);
+    // Reuse the timeline from the previous playback if the score has not been
+    // modified since then.
+    myEventCache.setOptions(options);
+    std::shared_ptr<const MidiTimeline> timeline = myEventCache.getTimeline();
+    if (!timeline)
+    {
+        MidiFile file;
+        file.load(myScore, options, &myEventCache);
 
-    const int ticks_per_beat = file.getTicksPerBeat();
+        // Merge the MIDI events for each track. Each track is already sorted.
+        for (MidiEventList &track : file.getTracks())
+            track.convertToAbsoluteTicks();
 
-    // Merge the MIDI evvents for each track.
-    MidiEventList events;
-    for (MidiEventList &track : file.getTracks())
-    {
-        track.convertToAbsoluteTicks();
-        events.concat(track);
+        timeline = std::make_shared<const MidiTimeline>(
+            MidiEventList::merge(file.getTracks()), file.getTicksPerBeat(),
+            file.getPlayedBars());
+        myEventCache.setTimeline(timeline);
     }
 
-    // TODO - since each track is already sorted, an n-way merge should be
-    // faster.
-    std::stable_sort(events.begin(), events.end());
-    events.convertToDeltaTicks();
-
     // Initialize RtMidi and set the port.
     MidiOutputDevice device;
     if (!device.initialize(api, port))
@@ -122,93 +136,94 @@ void MidiPlayer::run()
         return;
     }
 
-    bool started = false;
-    int beat_duration = Midi::BEAT_DURATION_120_BPM;
     const SystemLocation start_location(myStartLocation.getSystemIndex(),
                                         myStartLocation.getPositionIndex());
     SystemLocation current_location = start_location;
+    std::unique_ptr<PlaybackClock> clock;
+    std::vector<const MidiEvent *> messages;
+
+    // Jump directly to the bar containing the start location, and restore the
+    // state of each channel (instruments, volume, etc) at that point.
+    const std::vector<MidiTimeline::Group> &groups = timeline->getGroups();
+    const MidiTimeline::Bar *start_bar = timeline->findBar(start_location);
+    size_t group_index = start_bar ? start_bar->myGroup : 0;
 
-    DurationType clock_drift(0);
+    for (const MidiEvent &event : timeline->getChannelState(group_index))
+        device.sendMessage(event.getData(), event.getDataSize());
 
-    for (auto event = events.begin(); event != events.end(); ++event)
+    for (; group_index < groups.size(); ++group_index)
     {
         if (!isPlaying())
             break;
 
-        if (event->isTempoChange())
-            beat_duration = event->getTempo();
+        const MidiTimeline::Group &group = groups[group_index];
+        auto event = group.myBegin;
 
-        // Skip events before the start location, except for events such as
-        // instrument changes. Tempo changes are tracked above.
-        if (!started)
+        // Skip events in the bar before the start location, except for events
+        // such as instrument changes.
+        if (!clock)
         {
-            if (event->getLocation() < start_location)
+            for (; event != group.myEnd && event->getLocation() < start_location;
+                 ++event)
             {
-                if (event->isProgramChange())
-                    device.sendMessage(event->getData());
-
-                continue;
-            }
-            else
-            {
-                performCountIn(device, event->getLocation(), beat_duration);
-
-                started = true;
+                if (event->isChannelMessage() && !event->isNoteOnOff())
+                {
+                    device.sendMessage(event->getData(),
+                                       event->getDataSize());
+                }
             }
-        }
-
-        auto start_timestamp = std::chrono::high_resolution_clock::now();
 
-        const int delta = event->getTicks();
-        assert(delta >= 0);
+            if (event == group.myEnd)
+                continue;
 
-		// Compute the time in microseconds that we should sleep for, and then
-        // adjust for accumulated timing errors (since sleep_for() is not
-        // perfectly precise).
-        auto sleep_duration = DurationType(
-            static_cast<int>(
-            boost::rational_cast<int>(
-                boost::rational<int>(delta, ticks_per_beat) * beat_duration) *
-            (100.0 / myPlaybackSpeed)));
+            performCountIn(device, event->getLocation(), group.myBeatDuration);
 
-        auto error_correction = std::min(sleep_duration, clock_drift);
-        clock_drift -= error_correction;
-        sleep_duration -= error_correction;
+            clock.reset(new PlaybackClock(group.myTime, myPlaybackSpeed));
+        }
+        else if (!clock->waitUntil(group.myTime, myIsPlaying, myPlaybackSpeed))
+            break;
 
-        if (sleep_duration.count() != 0)
-            std::this_thread::sleep_for(sleep_duration);
+        messages.clear();
+        bool position_changed = false;
+        bool system_changed = false;
 
-        // Don't play metronome events if the metronome is disabled.
-        if (!(event->isNoteOnOff() &&
-              event->getChannel() == METRONOME_CHANNEL &&
-            !myMetronomeEnabled))
+        for (; event != group.myEnd; ++event)
         {
-            device.sendMessage(event->getData());
-        }
+            // Don't play metronome events if the metronome is disabled.
+            if (!(event->isNoteOnOff() &&
+                  event->getChannel() == METRONOME_CHANNEL &&
+                  !myMetronomeEnabled))
+            {
+                messages.push_back(&*event);
+            }
 
-        // Notify listeners of the current playback position.
-        if (event->getLocation() != current_location)
-        {
             const SystemLocation &new_location = event->getLocation();
+            if (new_location != current_location)
+            {
+                // Don't move backwards unless a repeat occurred.
+                if (new_location < current_location &&
+                    !event->isPositionChange())
+                {
+                    continue;
+                }
+
+                if (new_location.getSystem() != current_location.getSystem())
+                    system_changed = true;
+
+                position_changed = true;
+                current_location = new_location;
+            }
+        }
 
-            // Don't move backwards unless a repeat occurred.
-            if (new_location < current_location && !event->isPositionChange())
-                continue;
-
-            if (new_location.getSystem() != current_location.getSystem())
-                emit playbackSystemChanged(new_location.getSystem());
-
-            emit playbackPositionChanged(new_location.getPosition());
+        device.sendMessages(messages.data(), messages.size());
 
-            current_location = new_location;
+        // Notify listeners of the current playback position.
+        if (position_changed)
+        {
+            myPositionChanges.push({ current_location.getSystem(),
+                                     current_location.getPosition(),
+                                     system_changed });
         }
-
-        // Accumulate any difference between the desired delta time and what
-        // actually happened.
-        auto end_timestamp = std::chrono::high_resolution_clock::now();
-        auto actual_duration = std::chrono::duration_cast<DurationType>(
-            end_timestamp - start_timestamp);
-        clock_drift += actual_duration - sleep_duration;
     }
 }
 
@@ -238,13 +253,12 @@ void MidiPlayer::performCountIn(MidiOutputDevice &device,
 
     const TimeSignature &time_sig = barline->getTimeSignature();
 
+    const int pulse_duration =
+        static_cast<int>(4 * int64_t(time_sig.getBeatsPerMeasure()) *
+                         beat_duration /
+                         (time_sig.getBeatValue() * time_sig.getNumPulses()));
     const auto tick_duration = DurationType(
-        static_cast<int>(boost::rational_cast<int>(
-                             boost::rational<int>(4, time_sig.getBeatValue()) *
-                             boost::rational<int>(time_sig.getBeatsPerMeasure(),
-                                                  time_sig.getNumPulses()) *
-                             beat_duration) *
-                         100.0 / myPlaybackSpeed));
+        static_cast<int>(pulse_duration * 100.0 / myPlaybackSpeed));
 
     // Play the count-in.
     device.setChannelMaxVolume(METRONOME_CHANNEL,
@@ -261,6 +275,28 @@ void MidiPlayer::performCountIn(MidiOutputDevice &device,
     }
 }
 
+void MidiPlayer::emitPositionChanges()
+{
+    PositionChange change;
+    bool position_changed = false;
+    bool system_changed = false;
+
+    // Only the most recent position is needed.
+    while (myPositionChanges.pop(change))
+    {
+        position_changed = true;
+        system_changed |= change.mySystemChanged;
+    }
+
+    if (!position_changed)
+        return;
+
+    if (system_changed)
+        emit playbackSystemChanged(change.mySystem);
+
+    emit playbackPositionChanged(change.myPosition);
+}
+
 void MidiPlayer::changePlaybackSpeed(int new_speed)
 {
     myPlaybackSpeed = new_speed;
@@ -20,8 +20,11 @@
 
 #include <atomic>
 #include <QThread>
+#include <QTimer>
 #include <score/scorelocation.h>
+#include <util/spscqueue.h>
 
+class MidiEventCache;
 class MidiFile;
 class MidiOutputDevice;
 class Score;
@@ -33,7 +36,7 @@ class MidiPlayer : public QThread
     Q_OBJECT
 
 public:
-    MidiPlayer(SettingsManager &settings_manager,
+    MidiPlayer(SettingsManager &settings_manager, MidiEventCache &event_cache,
                const ScoreLocation &start_location, int speed);
     ~MidiPlayer();
 
@@ -51,6 +54,11 @@ signals:
 private:
     virtual void run() override;
 
+    /// Emits signals for any position changes from the playback thread. This
+    /// is run from the main thread, so that the playback thread is never
+    /// delayed by emitting signals.
+    void emitPositionChanges();
+
     void performCountIn(MidiOutputDevice &device,
                         const SystemLocation &location, int beat_duration);
 
@@ -58,12 +66,27 @@ private:
     bool isPlaying() const;
 
     SettingsManager &mySettingsManager;
+    /// Cached events from previous playback of the score.
+    MidiEventCache &myEventCache;
     const Score &myScore;
     ScoreLocation myStartLocation;
     std::atomic<bool> myIsPlaying;
     std::atomic<bool> myMetronomeEnabled;
     /// The current playback speed (percent).
     std::atomic<int> myPlaybackSpeed;
+
+    struct PositionChange
+    {
+        int mySystem;
+        int myPosition;
+        bool mySystemChanged;
+    };
+
+    /// Position changes that have not yet been sent to listeners. If the
+    /// queue is full, changes are dropped rather than blocking playback.
+    SpscQueue<PositionChange, 256> myPositionChanges;
+    /// Periodically checks for position changes.
+    QTimer myPositionTimer;
 };
 
 #endif
@@ -0,0 +1,272 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batchconverter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <chrono>
+#include <formats/fileformatmanager.h>
+#include <formats/powertab/powertabexporter.h>
+#include <future>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <score/score.h>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+size_t getPeakMemoryUsage()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    // ru_maxrss is in bytes on OS X, and kilobytes elsewhere.
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+static std::string getExtension(const fs::path &path)
+{
+    std::string extension = path.extension().string();
+    if (!extension.empty() && extension[0] == '.')
+        extension.erase(0, 1);
+
+    boost::algorithm::to_lower(extension);
+    return extension;
+}
+
+BatchConverter::Options::Options()
+    : myUseBinaryEncoding(false),
+      myNumThreads(std::max(1u, std::thread::hardware_concurrency())),
+      myFailFast(false)
+{
+}
+
+BatchConverter::BatchConverter(const SettingsManager &settings_manager,
+                               const Options &options)
+    : mySettingsManager(settings_manager),
+      myOptions(options),
+      myFormatManager(new FileFormatManager(settings_manager))
+{
+    if (myOptions.myOutputFormat &&
+        !myFormatManager->findExportFormat(*myOptions.myOutputFormat))
+    {
+        throw std::runtime_error("Unsupported output format: " +
+                                 *myOptions.myOutputFormat);
+    }
+}
+
+BatchConverter::~BatchConverter()
+{
+}
+
+void BatchConverter::addPath(const fs::path &path)
+{
+    if (!fs::is_directory(path))
+    {
+        myFiles.push_back({ path, path.filename() });
+        return;
+    }
+
+    std::vector<Input> files;
+    for (fs::recursive_directory_iterator it(path), end; it != end; ++it)
+    {
+        if (!fs::is_regular_file(it->status()))
+            continue;
+
+        const fs::path &file = it->path();
+        if (!myFormatManager->findImportFormat(getExtension(file)))
+            continue;
+
+        // Compute the path relative to the directory that was searched.
+        fs::path relative_path;
+        auto file_it = file.begin();
+        for (auto dir_it = path.begin();
+             dir_it != path.end() && file_it != file.end(); ++dir_it)
+        {
+            ++file_it;
+        }
+        for (; file_it != file.end(); ++file_it)
+            relative_path /= *file_it;
+
+        files.push_back({ file, relative_path });
+    }
+
+    // Process the files in a predictable order.
+    std::sort(files.begin(), files.end(), [](const Input &a, const Input &b) {
+        return a.myPath < b.myPath;
+    });
+    myFiles.insert(myFiles.end(), files.begin(), files.end());
+}
+
+BatchConverter::Result BatchConverter::process(FileFormatManager &manager,
+                                               const Input &input) const
+{
+    Result result;
+    result.myInputPath = input.myPath;
+    result.mySuccess = false;
+    result.myDuration = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+        boost::optional<FileFormat> format =
+            manager.findImportFormat(getExtension(input.myPath));
+        if (!format)
+            throw std::runtime_error("Unsupported file format");
+
+        Score score;
+        manager.importFile(score, input.myPath, *format);
+
+        if (myOptions.myOutputFormat)
+        {
+            const std::string &extension = *myOptions.myOutputFormat;
+            result.myOutputPath = myOptions.myOutputDir / input.myRelativePath;
+            result.myOutputPath.replace_extension(extension);
+
+            // Avoid overwriting the input file.
+            if (fs::exists(result.myOutputPath) &&
+                fs::equivalent(result.myOutputPath, input.myPath))
+            {
+                throw std::runtime_error("Output file is the same as the "
+                                         "input file");
+            }
+
+            fs::create_directories(result.myOutputPath.parent_path());
+
+            if (myOptions.myUseBinaryEncoding && extension == "pt2")
+            {
+                PowerTabExporter exporter(PowerTabExporter::Encoding::Binary);
+                exporter.save(result.myOutputPath, score);
+            }
+            else
+            {
+                manager.exportFile(score, result.myOutputPath,
+                                   *manager.findExportFormat(extension));
+            }
+        }
+
+        result.mySuccess = true;
+    }
+    catch (const std::exception &e)
+    {
+        result.myError = e.what();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    result.myDuration =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    return result;
+}
+
+static void printResult(std::ostream &report,
+                        const BatchConverter::Result &result)
+{
+    report << (result.mySuccess ? "OK   " : "FAIL ") << result.myInputPath.string();
+    if (!result.myOutputPath.empty() && result.mySuccess)
+        report << " -> " << result.myOutputPath.string();
+
+    report << std::fixed << std::setprecision(1) << " (" << result.myDuration
+           << " ms)";
+
+    if (!result.mySuccess)
+        report << ": " << result.myError;
+
+    report << std::endl;
+}
+
+bool BatchConverter::run(std::ostream &report)
+{
+    const int num_threads = std::max(
+        1, std::min(myOptions.myNumThreads, static_cast<int>(myFiles.size())));
+
+    std::atomic<size_t> next_file(0);
+    std::atomic<bool> stop(false);
+    std::atomic<int> num_failed(0);
+    std::mutex report_mutex;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Each worker has its own importers and exporters, since they may keep
+    // state while loading a file.
+    auto worker = [&]() {
+        FileFormatManager manager(mySettingsManager);
+
+        while (!stop)
+        {
+            const size_t i = next_file++;
+            if (i >= myFiles.size())
+                break;
+
+            const Result result = process(manager, myFiles[i]);
+            if (!result.mySuccess)
+            {
+                ++num_failed;
+                if (myOptions.myFailFast)
+                    stop = true;
+            }
+
+            std::lock_guard<std::mutex> lock(report_mutex);
+            printResult(report, result);
+        }
+    };
+
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i < num_threads; ++i)
+        tasks.push_back(std::async(std::launch::async, worker));
+
+    for (auto &task : tasks)
+        task.get();
+
+    auto end = std::chrono::steady_clock::now();
+    const size_t num_processed = std::min(next_file.load(), myFiles.size());
+
+    report << std::endl
+           << "Processed " << num_processed << " of " << myFiles.size()
+           << " files (" << num_failed << " failed) in " << std::fixed
+           << std::setprecision(2)
+           << std::chrono::duration<double>(end - start).count()
+           << " s using " << num_threads << " threads, peak process memory "
+           << (getPeakMemoryUsage() / (1024 * 1024)) << " MB" << std::endl;
+
+    return num_failed == 0;
+}
@@ -0,0 +1,99 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLI_BATCHCONVERTER_H
+#define CLI_BATCHCONVERTER_H
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional/optional.hpp>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+class FileFormatManager;
+class SettingsManager;
+
+/// Converts or validates a batch of files without any GUI, using a pool of
+/// worker threads.
+class BatchConverter
+{
+public:
+    struct Options
+    {
+        Options();
+
+        /// The extension of the output format (e.g. "pt2" or "mid"). If not
+        /// set, the files are only imported to check that they can be read.
+        boost::optional<std::string> myOutputFormat;
+        /// The directory to write converted files to. Files found by
+        /// searching a directory keep their relative path.
+        boost::filesystem::path myOutputDir;
+        /// Whether to write .pt2 files using the compact binary encoding.
+        bool myUseBinaryEncoding;
+        /// The number of worker threads.
+        int myNumThreads;
+        /// Whether to stop processing new files after the first failure.
+        bool myFailFast;
+    };
+
+    /// The outcome of processing a single file.
+    struct Result
+    {
+        boost::filesystem::path myInputPath;
+        boost::filesystem::path myOutputPath;
+        bool mySuccess;
+        std::string myError;
+        /// Time spent importing and exporting the file, in milliseconds.
+        double myDuration;
+    };
+
+    BatchConverter(const SettingsManager &settings_manager,
+                   const Options &options);
+    ~BatchConverter();
+
+    /// Adds a file, or all of the supported files in a directory tree.
+    void addPath(const boost::filesystem::path &path);
+
+    size_t getNumFiles() const { return myFiles.size(); }
+
+    /// Processes all of the files and writes a report for each one to the
+    /// given stream. Returns false if any file could not be processed.
+    bool run(std::ostream &report);
+
+private:
+    struct Input
+    {
+        boost::filesystem::path myPath;
+        /// The path relative to the directory it was found in.
+        boost::filesystem::path myRelativePath;
+    };
+
+    Result process(FileFormatManager &manager, const Input &input) const;
+
+    const SettingsManager &mySettingsManager;
+    const Options myOptions;
+    /// Used for finding the format of each input file.
+    std::unique_ptr<FileFormatManager> myFormatManager;
+    std::vector<Input> myFiles;
+};
+
+/// Returns the peak memory usage of the process, in bytes. This is shared by
+/// all of the worker threads, so it is only reported for the whole batch.
+size_t getPeakMemoryUsage();
+
+#endif
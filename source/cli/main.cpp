@@ -0,0 +1,100 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batchconverter.h"
+
+#include <app/settingsmanager.h>
+#include <boost/program_options.hpp>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+    po::options_description desc(
+        "Usage: pteconvert [options] [files or directories...]\n"
+        "Converts or validates files without starting the editor.\n"
+        "If no output format is given, the files are only imported.\n\n"
+        "Options");
+
+    BatchConverter::Options options;
+    SettingsManager settings_manager;
+
+    try
+    {
+        desc.add_options()
+            ("help,h", "Displays this help.")
+            ("format,f", po::value<std::string>(),
+             "The output format's extension (e.g. pt2 or mid).")
+            ("output,o", po::value<std::string>()->default_value("."),
+             "The directory to write converted files to.")
+            ("binary", "Write .pt2 files using the compact binary encoding.")
+            ("jobs,j", po::value<int>(&options.myNumThreads),
+             "The number of files to process in parallel (defaults to the "
+             "number of cores).")
+            ("fail-fast", "Stop after the first file that fails.")
+            ("settings", po::value<std::string>(),
+             "A directory containing a settings file to load, e.g. for the "
+             "MIDI export options.")
+            ("inputs", po::value<std::vector<std::string>>(),
+             "The files or directories to process.");
+        po::positional_options_description p;
+        p.add("inputs", -1);
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv)
+                      .options(desc)
+                      .positional(p)
+                      .run(),
+                  vm);
+        po::notify(vm);
+
+        if (vm.count("help") || !vm.count("inputs"))
+        {
+            std::cout << desc << std::endl;
+            return vm.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        if (vm.count("format"))
+            options.myOutputFormat = vm["format"].as<std::string>();
+        options.myOutputDir = vm["output"].as<std::string>();
+        options.myUseBinaryEncoding = vm.count("binary") != 0;
+        options.myFailFast = vm.count("fail-fast") != 0;
+
+        if (vm.count("settings"))
+            settings_manager.load(vm["settings"].as<std::string>());
+
+        BatchConverter converter(settings_manager, options);
+        for (const std::string &input :
+             vm["inputs"].as<std::vector<std::string>>())
+        {
+            converter.addPath(input);
+        }
+
+        std::cout << "Found " << converter.getNumFiles() << " files"
+                  << std::endl;
+
+        return converter.run(std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -122,6 +122,9 @@ void PreferencesDialog::loadCurrentSettings()
     ui->openInNewWindowCheckBox->setChecked(
         settings->get(Settings::OpenFilesInNewWindow));
 
+    ui->cacheSystemImagesCheckBox->setChecked(
+        settings->get(Settings::CacheSystemImages));
+
     ui->defaultInstrumentNameLineEdit->setText(
         QString::fromStdString(settings->get(Settings::DefaultInstrumentName)));
     ui->defaultPresetComboBox->setCurrentIndex(
@@ -173,6 +176,9 @@ void PreferencesDialog::accept()
     settings->set(Settings::OpenFilesInNewWindow,
                   ui->openInNewWindowCheckBox->isChecked());
 
+    settings->set(Settings::CacheSystemImages,
+                  ui->cacheSystemImagesCheckBox->isChecked());
+
     settings->set(Settings::DefaultInstrumentName,
                   ui->defaultInstrumentNameLineEdit->text().toStdString());
 
@@ -0,0 +1,46 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "bytereader.h"
+
+#include <formats/fileformat.h>
+
+ByteReader::ByteReader(const uint8_t *data, size_t size)
+    : myData(data), mySize(size), myPosition(0)
+{
+}
+
+void ByteReader::seek(size_t position)
+{
+    // Like std::istream, seeking past the end is allowed but any further
+    // reads will fail.
+    myPosition = position;
+}
+
+void ByteReader::skip(ptrdiff_t numBytes)
+{
+    if (numBytes < 0 && static_cast<size_t>(-numBytes) > myPosition)
+        throw FileFormatException("Invalid file offset");
+
+    seek(myPosition + numBytes);
+}
+
+void ByteReader::checkAvailable(size_t length) const
+{
+    if (myPosition > mySize || length > mySize - myPosition)
+        throw FileFormatException("Unexpected end of file");
+}
@@ -0,0 +1,128 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef FORMATS_BYTEREADER_H
+#define FORMATS_BYTEREADER_H
+
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/// Reads little-endian values from an in-memory buffer, such as a
+/// memory-mapped file. The data is not copied, and must outlive the reader.
+class ByteReader
+{
+public:
+    ByteReader(const uint8_t *data, size_t size);
+
+    /// Reads a little-endian value (e.g. uint32_t, int16_t, bool, double).
+    /// @throw FileFormatException if the end of the data is reached.
+    template <typename T>
+    T read();
+
+    /// Returns a pointer to the next \p length bytes, and advances past them.
+    /// @throw FileFormatException if the end of the data is reached.
+    const uint8_t *readBytes(size_t length);
+
+    /// Returns a view of the next \p length characters.
+    /// @throw FileFormatException if the end of the data is reached.
+    boost::string_ref readString(size_t length);
+
+    /// Moves to the given offset from the start of the data. Reads past the end
+    /// of the data will fail.
+    void seek(size_t position);
+    /// Moves forward (or backward) by the given number of bytes.
+    void skip(ptrdiff_t numBytes);
+
+    size_t getPosition() const { return myPosition; }
+    size_t getSize() const { return mySize; }
+    bool isAtEnd() const { return myPosition >= mySize; }
+
+private:
+    /// Throws an exception if there are fewer than \p length bytes remaining.
+    void checkAvailable(size_t length) const;
+
+    template <typename T>
+    static T decode(const uint8_t *bytes, std::true_type /* floating point */);
+    template <typename T>
+    static T decode(const uint8_t *bytes, std::false_type /* integral */);
+
+    const uint8_t *myData;
+    size_t mySize;
+    size_t myPosition;
+};
+
+template <typename T>
+inline T ByteReader::read()
+{
+    static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+
+    checkAvailable(sizeof(T));
+    const T value = decode<T>(myData + myPosition,
+                              std::is_floating_point<T>());
+    myPosition += sizeof(T);
+    return value;
+}
+
+template <>
+inline bool ByteReader::read<bool>()
+{
+    return read<uint8_t>() != 0;
+}
+
+template <typename T>
+inline T ByteReader::decode(const uint8_t *bytes, std::false_type)
+{
+    typedef typename std::make_unsigned<T>::type UnsignedType;
+
+    UnsignedType value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<UnsignedType>(bytes[i]) << (8 * i);
+
+    return static_cast<T>(value);
+}
+
+template <typename T>
+inline T ByteReader::decode(const uint8_t *bytes, std::true_type)
+{
+    typedef typename std::conditional<sizeof(T) == sizeof(uint32_t), uint32_t,
+                                      uint64_t>::type BitsType;
+    static_assert(sizeof(T) == sizeof(BitsType), "Unsupported float type");
+
+    const BitsType bits = decode<BitsType>(bytes, std::false_type());
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline const uint8_t *ByteReader::readBytes(size_t length)
+{
+    checkAvailable(length);
+    const uint8_t *bytes = myData + myPosition;
+    myPosition += length;
+    return bytes;
+}
+
+inline boost::string_ref ByteReader::readString(size_t length)
+{
+    const char *str = reinterpret_cast<const char *>(readBytes(length));
+    return boost::string_ref(str, length);
+}
+
+#endif
@@ -37,6 +37,16 @@ FileFormatManager::FileFormatManager(const SettingsManager &settings_manager)
 
 boost::optional<FileFormat> FileFormatManager::findFormat(
         const std::string &extension) const
+{
+    boost::optional<FileFormat> format = findImportFormat(extension);
+    if (!format)
+        format = findExportFormat(extension);
+
+    return format;
+}
+
+boost::optional<FileFormat> FileFormatManager::findImportFormat(
+        const std::string &extension) const
 {
     for (auto &importer : myImporters)
     {
@@ -44,6 +54,12 @@ boost::optional<FileFormat> FileFormatManager::findFormat(
             return importer->fileFormat();
     }
 
+    return boost::none;
+}
+
+boost::optional<FileFormat> FileFormatManager::findExportFormat(
+        const std::string &extension) const
+{
     for (auto &exporter : myExporters)
     {
         if (exporter->fileFormat().contains(extension))
@@ -36,6 +36,12 @@ public:
 
     /// Returns the file format corresponding to the given extension.
     boost::optional<FileFormat> findFormat(const std::string &extension) const;
+    /// Returns the importable file format corresponding to the extension.
+    boost::optional<FileFormat> findImportFormat(
+        const std::string &extension) const;
+    /// Returns the exportable file format corresponding to the extension.
+    boost::optional<FileFormat> findExportFormat(
+        const std::string &extension) const;
 
     /// Returns a correctly formatted file filter for a Qt file dialog.
     /// e.g. "FileType (*.ext1 *.ext2);;FileType2 (*.ext3)".
@@ -18,62 +18,40 @@
 #include "bitstream.h"
 
 #include <cassert>
-#include <istream>
-#include "util.h"
 
 static const uint32_t BYTE_LENGTH = 8;
 
-Gpx::BitStream::BitStream(std::istream &stream)
-    : myPosition(0)
+Gpx::BitStream::BitStream(const uint8_t *data, size_t size)
+    : myData(data),
+      mySize(size),
+      myNextByte(0),
+      myBuffer(0),
+      myBufferedBits(0),
+      myPosition(0),
+      myBitLength(size * BYTE_LENGTH)
 {
-    // Copy data from the stream into an internal buffer.
-    stream.seekg(0, std::ios::end);
-    myBytes.resize(stream.tellg());
-
-    stream.seekg(0, std::ios::beg);
-    stream.read(reinterpret_cast<char *>(&myBytes[0]), myBytes.size());
 }
 
-uint32_t Gpx::BitStream::readInt()
+void Gpx::BitStream::refill()
 {
-    assert(myPosition % BYTE_LENGTH == 0);
-
-    const uint32_t value = Gpx::Util::readUInt(myBytes,
-                                               myPosition / BYTE_LENGTH);
-    myPosition += sizeof(uint32_t) * BYTE_LENGTH;
-    return value;
-}
-
-bool Gpx::BitStream::readBit()
-{
-    if (myPosition / BYTE_LENGTH >= myBytes.size())
-        return 0;
-
-    char byte = myBytes[myPosition / BYTE_LENGTH];
-    byte >>= ((BYTE_LENGTH - 1) - (myPosition % BYTE_LENGTH));
-    byte &= 0x01;
-
-    ++myPosition;
-
-    return byte != 0;
+    while (myBufferedBits <= 56 && myNextByte < mySize)
+    {
+        myBuffer |= static_cast<uint64_t>(myData[myNextByte++])
+                    << (56 - myBufferedBits);
+        myBufferedBits += BYTE_LENGTH;
+    }
 }
 
-int32_t Gpx::BitStream::readBits(int n, BitOrder order)
+uint32_t Gpx::BitStream::readInt()
 {
-    int32_t value = 0;
+    assert(myPosition % BYTE_LENGTH == 0);
 
-    if (order == Reversed)
-    {
-        for (int i = 0; i < n; ++i)
-            value |= (readBit() << i);
-    }
-    else
-    {
-        for (int i = n - 1; i >= 0; --i)
-            value |= (readBit() << i);
-    }
+    const uint32_t n1 = readBits(8);
+    const uint32_t n2 = readBits(8);
+    const uint32_t n3 = readBits(8);
+    const uint32_t n4 = readBits(8);
 
-    return value;
+    return n1 | (n2 << 8) | (n3 << 16) | (n4 << 24);
 }
 
 size_t Gpx::BitStream::getLocation() const
@@ -83,5 +61,5 @@ size_t Gpx::BitStream::getLocation() const
 
 bool Gpx::BitStream::isAtEnd() const
 {
-    return getLocation() >= (myBytes.size() - 1);
+    return getLocation() + 1 >= mySize;
 }
@@ -18,15 +18,17 @@
 #ifndef FORMATS_GPX_BITSTREAM_H
 #define FORMATS_GPX_BITSTREAM_H
 
+#include <cstddef>
 #include <cstdint>
-#include <iosfwd>
-#include <vector>
 
 namespace Gpx
 {
 
-/// Provides the ability to read individual bits from a stream.
+/// Provides the ability to read individual bits from a buffer.
 /// This is required for the compression scheme used in .gpx files.
+/// Bits are read from the most significant bit of each byte first, and are
+/// buffered 64 bits at a time. Reading past the end of the data produces zero
+/// bits.
 class BitStream
 {
 public:
@@ -36,17 +38,48 @@ public:
         Reversed
     };
 
-    BitStream(std::istream &stream);
+    /// The data is not copied, and must outlive the bit stream.
+    BitStream(const uint8_t *data, size_t size);
 
     /// Reads a 32-bit unsigned integer from the stream. This assumes that the
     /// stream position is exactly on the start of a byte.
     uint32_t readInt();
 
     /// Reads the next bit from the stream.
-    bool readBit();
+    bool readBit()
+    {
+        return readBits(1) != 0;
+    }
+
+    /// Reads the next n bits (at most 32) from the stream into an integer.
+    int32_t readBits(int n, BitOrder order = Normal)
+    {
+        if (n <= 0)
+            return 0;
+
+        if (myBufferedBits < n)
+            refill();
 
-    /// Reads the next n bits from the stream into an integer.
-    int32_t readBits(int n, BitOrder = Normal);
+        uint32_t value = static_cast<uint32_t>(myBuffer >> (64 - n));
+        myBuffer <<= n;
+        myBufferedBits -= n;
+        if (myBufferedBits < 0)
+            myBufferedBits = 0;
+
+        myPosition += n;
+        if (myPosition > myBitLength)
+            myPosition = myBitLength;
+
+        if (order == Reversed)
+        {
+            uint32_t reversed = 0;
+            for (int i = 0; i < n; ++i, value >>= 1)
+                reversed = (reversed << 1) | (value & 1);
+            value = reversed;
+        }
+
+        return static_cast<int32_t>(value);
+    }
 
     /// Returns the position in the stream (measured in bytes).
     size_t getLocation() const;
@@ -55,10 +88,21 @@ public:
     bool isAtEnd() const;
 
 private:
+    /// Loads as many whole bytes into the buffer as will fit.
+    void refill();
+
+    const uint8_t *myData;
+    size_t mySize;
+    /// The index of the next byte to be loaded into the buffer.
+    size_t myNextByte;
+    /// The upcoming bits, starting from the most significant bit.
+    uint64_t myBuffer;
+    /// The number of valid bits in the buffer.
+    int myBufferedBits;
     /// The current position in the input (measured in bits).
     size_t myPosition;
-    /// The compressed data being read.
-    std::vector<uint8_t> myBytes;
+    /// The length of the input (measured in bits).
+    size_t myBitLength;
 };
 
 }
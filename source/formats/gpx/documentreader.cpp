@@ -45,9 +45,9 @@ static void convertStringToList(const std::string &source, std::vector<T> &dest)
         std::cerr << "Parsing of list failed!!" << std::endl;
 }
 
-Gpx::DocumentReader::DocumentReader(const std::string &xml)
+Gpx::DocumentReader::DocumentReader(boost::string_ref xml)
 {
-    xml_parse_result result = myXmlData.load(xml.c_str());
+    xml_parse_result result = myXmlData.load_buffer(xml.data(), xml.size());
 
     if (result.status != pugi::status_ok)
         throw std::runtime_error(result.description());
@@ -295,7 +295,7 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
         if (startPos > POSITIONS_PER_SYSTEM)
         {
             system.getBarlines().back().setPosition(startPos + 1);
-            score.insertSystem(system);
+            score.insertSystem(std::move(system));
             system = System();
 
             for (auto &player : score.getPlayers())
@@ -382,14 +382,14 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
                                      note.getString() << std::endl;
                     }
                     else
-                        pos.insertNote(note);
+                        pos.insertNote(std::move(note));
                 }
 
                 if (pos.getNotes().empty())
                     pos.setRest();
 
                 pos.setPosition(currentPos++);
-                staff.getVoices()[0].insertPosition(pos);
+                staff.getVoices()[0].insertPosition(std::move(pos));
             }
 
             nextPos = std::max(nextPos, currentPos);
@@ -406,7 +406,7 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
     }
 
     system.getBarlines().back().setPosition(startPos + 1);
-    score.insertSystem(system);
+    score.insertSystem(std::move(system));
 }
 
 void Gpx::DocumentReader::readBarlineType(const xml_node &masterBar,
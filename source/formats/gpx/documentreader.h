@@ -18,6 +18,7 @@
 #ifndef FORMATS_GPX_DOCUMENTREADER_H
 #define FORMATS_GPX_DOCUMENTREADER_H
 
+#include <boost/utility/string_ref.hpp>
 #include <map>
 #include <pugixml.hpp>
 #include <score/note.h>
@@ -90,7 +91,7 @@ struct Automation
 class DocumentReader
 {
 public:
-    DocumentReader(const std::string &xml);
+    DocumentReader(boost::string_ref xml);
 
     void readScore(Score &score);
 
@@ -18,8 +18,9 @@
 #include "filesystem.h"
 
 #include "bitstream.h"
+#include <algorithm>
 #include <boost/algorithm/clamp.hpp>
-#include <cassert>
+#include <cstring>
 #include <formats/fileformat.h>
 #include "util.h"
 
@@ -30,24 +31,29 @@ enum ChunkHeader
 };
 
 static const uint32_t SECTOR_SIZE = 0x1000;
+static const size_t MAX_COMPRESSION_RATIO = 64;
+static const uint32_t BCFS_HEADER = 0x53464342;
+static const uint32_t BCFZ_HEADER = 0x5a464342;
 
-Gpx::FileSystem::FileSystem(std::istream &stream)
+Gpx::FileSystem::FileSystem(const uint8_t *data, size_t size)
 {
-    // Decompress the input file and return the filesystem.
-    Gpx::BitStream input(stream);
-
-    const uint32_t BCFS_HEADER = 0x53464342;
-    const uint32_t BCFZ_HEADER = 0x5a464342;
+    decompress(data, size);
+}
 
-    const uint32_t header = input.readInt();
+void Gpx::FileSystem::decompress(const uint8_t *data, size_t size)
+{
+    // Decompress the input file and return the filesystem.
+    Gpx::BitStream input(data, size);
 
-    // This should be a compressed file right now.
-    if (header != BCFZ_HEADER)
+    if (size < 8 || input.readInt() != BCFZ_HEADER)
         throw FileFormatException("Invalid header");
 
+    // The header gives the expected size of the uncompressed data, so the
+    // output can be allocated up front and written to directly. Don't trust it
+    // blindly for corrupt files, though.
     const uint32_t length = input.readInt();
-    std::vector<uint8_t> output;
-    output.reserve(length);
+    myData.resize(std::min<size_t>(length, size * MAX_COMPRESSION_RATIO));
+    size_t outputSize = 0;
 
     // We now have a succession of compressed and uncompressed chunks.
     while (!input.isAtEnd() && input.getLocation() < length)
@@ -59,9 +65,11 @@ Gpx::FileSystem::FileSystem(std::istream &stream)
         if (chunkHeader == Uncompressed)
         {
             const int32_t rawLength = input.readBits(2, Gpx::BitStream::Reversed);
+            if (outputSize + rawLength > myData.size())
+                myData.resize(std::max(myData.size() * 2, outputSize + rawLength));
 
             for (int32_t i = 0; i < rawLength; ++i)
-                output.push_back(input.readBits(8));
+                myData[outputSize++] = static_cast<uint8_t>(input.readBits(8));
         }
         // For a compressed chunk, we have a 4-bit integer giving a length P,
         // then two integers of P bits representing the offset and length of the
@@ -71,30 +79,36 @@ Gpx::FileSystem::FileSystem(std::istream &stream)
         {
             const int32_t p = input.readBits(4);
             const int32_t offset = input.readBits(p, Gpx::BitStream::Reversed);
-            const size_t startPos = output.size() - offset;
+            if (static_cast<size_t>(offset) > outputSize)
+                throw FileFormatException("Invalid GPX Format");
 
+            // Since the length is at most the offset, the source and
+            // destination ranges never overlap.
             const int32_t length = boost::algorithm::clamp<int32_t>(
                 input.readBits(p, Gpx::BitStream::Reversed), 0, offset);
+            if (outputSize + length > myData.size())
+                myData.resize(std::max(myData.size() * 2, outputSize + length));
 
-            std::copy(output.begin() + startPos,
-                      output.begin() + startPos + length,
-                      std::back_inserter(output));
+            std::memcpy(&myData[outputSize], &myData[outputSize - offset],
+                        length);
+            outputSize += length;
         }
     }
 
+    myData.resize(outputSize);
+
     // The data we just read should now have a header indicating that it's
     // uncompressed!
-    const uint32_t newHeader = Gpx::Util::readUInt(output, 0);
-    if (newHeader != BCFS_HEADER)
+    if (myData.size() < 4 || Gpx::Util::readUInt(myData, 0) != BCFS_HEADER)
         throw FileFormatException("Invalid GPX Format");
 
-    readUncompressedData(output);
+    readUncompressedData();
 }
 
-const std::string &Gpx::FileSystem::getFileContents(
+boost::string_ref Gpx::FileSystem::getFileContents(
         const std::string &filename) const
 {
-    std::map<std::string, std::string>::const_iterator file = myFiles.find(filename);
+    auto file = myFiles.find(filename);
 
     if (file == myFiles.end())
         throw FileFormatException("Invalid filename");
@@ -102,51 +116,82 @@ const std::string &Gpx::FileSystem::getFileContents(
         return file->second;
 }
 
-void Gpx::FileSystem::readUncompressedData(std::vector<uint8_t> &data)
+void Gpx::FileSystem::readUncompressedData()
 {
-    // Remove the BCFS header.
-    data.erase(data.begin(), data.begin() + 4);
+    // Skip the BCFS header.
+    const uint8_t *data = myData.data() + 4;
+    const size_t dataSize = myData.size() - 4;
     size_t offset = 0;
 
     // Read all files from the file system.
-    while ( (offset = (offset + SECTOR_SIZE)) + 3 < data.size())
+    while ( (offset = (offset + SECTOR_SIZE)) + 3 < dataSize)
     {
-        if (Util::readUInt(data, offset) == 2)
+        if (Util::readUInt(data + offset) == 2)
         {
             const size_t fileNameIndex = offset + 4;
-            const size_t fileSizeIndex= offset + 0x8C;
-            const size_t blockIndex= offset + 0x94;
-
-            int block = 0;
-            int blockCount = 0;
-            std::vector<uint8_t> fileData;
-
-            // Read the file data.
-            while ((block = Util::readUInt(data,
-                                           blockIndex + 4 * blockCount)) != 0)
+            const size_t fileSizeIndex = offset + 0x8C;
+            const size_t blockIndex = offset + 0x94;
+
+            if (blockIndex + 4 > dataSize)
+                break;
+
+            // Find the range of each sector in the file, without copying
+            // anything yet.
+            std::vector<std::pair<size_t, size_t>> sectors;
+            size_t totalSize = 0;
+            bool contiguous = true;
+            uint32_t block = 0;
+            size_t blockCount = 0;
+
+            while (blockIndex + 4 * blockCount + 4 <= dataSize &&
+                   (block = Util::readUInt(data + blockIndex +
+                                           4 * blockCount)) != 0)
             {
                 offset = block * SECTOR_SIZE;
-                std::copy(data.begin() + offset,
-                          data.begin() +
-                          boost::algorithm::clamp<size_t>(offset + SECTOR_SIZE,
-                                                          0, data.size()),
-                          std::back_inserter(fileData));
+                const size_t start = std::min<size_t>(offset, dataSize);
+                const size_t end = std::min<size_t>(offset + SECTOR_SIZE,
+                                                    dataSize);
+
+                if (!sectors.empty() && sectors.back().second != start)
+                    contiguous = false;
+
+                sectors.push_back(std::make_pair(start, end));
+                totalSize += end - start;
                 ++blockCount;
             }
 
             // Read the file name and save the file.
-            const uint32_t fileSize = Util::readUInt(data, fileSizeIndex);
-            if (fileData.size() >= fileSize)
+            const uint32_t fileSize = Util::readUInt(data + fileSizeIndex);
+            if (totalSize >= fileSize)
             {
-                std::string fileName;
-                std::copy(data.begin() + fileNameIndex,
-                          data.begin() + fileNameIndex + 127,
-                          std::back_inserter(fileName));
+                const char *name = reinterpret_cast<const char *>(
+                    data + fileNameIndex);
+                std::string fileName(name, name + 127);
                 // Trim extra NULL characters.
                 fileName.erase(fileName.find_last_not_of('\0') + 1);
 
-                std::string file(fileData.begin(), fileData.begin() + fileSize);
-                myFiles[fileName] = file;
+                if (contiguous || fileSize == 0)
+                {
+                    // Refer directly to the decompressed data.
+                    const char *start = fileSize ? reinterpret_cast<const char *>(
+                        data + sectors.front().first) : "";
+                    myFiles[fileName] = boost::string_ref(start, fileSize);
+                }
+                else
+                {
+                    std::string file;
+                    file.reserve(fileSize);
+                    for (auto &sector : sectors)
+                    {
+                        const size_t n = std::min(sector.second - sector.first,
+                                                  fileSize - file.size());
+                        file.append(reinterpret_cast<const char *>(
+                                        data + sector.first), n);
+                    }
+
+                    myFragmentedFiles.push_back(std::move(file));
+                    myFiles[fileName] = myFragmentedFiles.back();
+                }
             }
         }
     }
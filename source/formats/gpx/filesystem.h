@@ -18,8 +18,9 @@
 #ifndef FORMATS_GPX_FILESYSTEM_H
 #define FORMATS_GPX_FILESYSTEM_H
 
+#include <boost/utility/string_ref.hpp>
 #include <cstdint>
-#include <iosfwd>
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -33,15 +34,24 @@ namespace Gpx
 class FileSystem
 {
 public:
-    FileSystem(std::istream &stream);
+    /// The compressed data is only needed during construction.
+    FileSystem(const uint8_t *data, size_t size);
 
-    const std::string &getFileContents(const std::string &filename) const;
+    /// Returns the contents of a file, which remain valid for the lifetime of
+    /// the filesystem.
+    boost::string_ref getFileContents(const std::string &filename) const;
 
 private:
-    void readUncompressedData(std::vector<uint8_t> &data);
-
+    void decompress(const uint8_t *data, size_t size);
+    void readUncompressedData();
+
+    /// The decompressed filesystem.
+    std::vector<uint8_t> myData;
+    /// Contents of files whose sectors are not contiguous, and so must be
+    /// copied.
+    std::deque<std::string> myFragmentedFiles;
     /// Maps filenames to file contents.
-    std::map<std::string, std::string> myFiles;
+    std::map<std::string, boost::string_ref> myFiles;
 };
 
 }
@@ -20,11 +20,10 @@
 #include "filesystem.h"
 #include "documentreader.h"
 
+#include <formats/mappedfile.h>
 #include <score/score.h>
 #include <score/utils/scorepolisher.h>
 
-#include <boost/filesystem/fstream.hpp>
-
 GpxImporter::GpxImporter()
     : FileFormatImporter(FileFormat("Guitar Pro 6", { "gpx" }))
 {
@@ -33,8 +32,8 @@ GpxImporter::GpxImporter()
 void GpxImporter::load(const boost::filesystem::path &filename, Score &score)
 {
     // Load the data, decompress, and open as XML document.
-    boost::filesystem::ifstream file(filename, std::ios::binary | std::ios::in);
-    Gpx::FileSystem fs(file);
+    const MappedFile file(filename);
+    Gpx::FileSystem fs(file.data(), file.size());
 
     Gpx::DocumentReader reader(fs.getFileContents("score.gpif"));
     reader.readScore(score);
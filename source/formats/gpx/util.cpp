@@ -19,10 +19,15 @@
 
 uint32_t Gpx::Util::readUInt(const std::vector<uint8_t> &bytes, size_t index)
 {
-    const uint32_t n1 = bytes[index];
-    const uint32_t n2 = bytes[index + 1];
-    const uint32_t n3 = bytes[index + 2];
-    const uint32_t n4 = bytes[index + 3];
+    return readUInt(bytes.data() + index);
+}
+
+uint32_t Gpx::Util::readUInt(const uint8_t *bytes)
+{
+    const uint32_t n1 = bytes[0];
+    const uint32_t n2 = bytes[1];
+    const uint32_t n3 = bytes[2];
+    const uint32_t n4 = bytes[3];
 
     return n1 | (n2 << 8) | (n3 << 16) | (n4 << 24);
 }
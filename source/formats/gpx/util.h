@@ -26,6 +26,8 @@ namespace Gpx {
 namespace Util {
     /// Converts 4 bytes starting at the given index into an integer.
     uint32_t readUInt(const std::vector<uint8_t> &bytes, size_t index);
+    /// Converts the 4 bytes starting at the given location into an integer.
+    uint32_t readUInt(const uint8_t *bytes);
 }
 }
 
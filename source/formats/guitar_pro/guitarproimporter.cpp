@@ -18,10 +18,9 @@
 #include "guitarproimporter.h"
 
 #include <boost/date_time/gregorian/gregorian_types.hpp>
-#include <boost/filesystem/fstream.hpp>
-
 #include <formats/guitar_pro/document.h>
 #include <formats/guitar_pro/inputstream.h>
+#include <formats/mappedfile.h>
 #include <score/score.h>
 #include <score/utils.h>
 #include <score/utils/scorepolisher.h>
@@ -37,8 +36,8 @@ GuitarProImporter::GuitarProImporter()
 void GuitarProImporter::load(const boost::filesystem::path &filename,
                              Score &score)
 {
-    boost::filesystem::ifstream in(filename, std::ios::binary | std::ios::in);
-    Gp::InputStream stream(in);
+    const MappedFile file(filename);
+    Gp::InputStream stream(file.data(), file.size());
 
     Gp::Document document;
     document.load(stream);
@@ -328,7 +327,7 @@ void GuitarProImporter::convertScore(const Gp::Document &doc, Score &score)
         if (startPos > POSITIONS_PER_SYSTEM)
         {
             system.getBarlines().back().setPosition(startPos + 1);
-            score.insertSystem(system);
+            score.insertSystem(std::move(system));
             system = System();
 
             // Add a staff for each player.
@@ -385,7 +384,7 @@ void GuitarProImporter::convertScore(const Gp::Document &doc, Score &score)
     if (lastBar.getBarType() != Barline::RepeatEnd)
         lastBar.setBarType(Barline::DoubleBarFine);
 
-    score.insertSystem(system);
+    score.insertSystem(std::move(system));
 }
 
 int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
@@ -414,7 +413,7 @@ int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
                     break;
                 }
 
-                gracePos.insertNote(note);
+                gracePos.insertNote(std::move(note));
                 gracePos.setDurationType(static_cast<Position::DurationType>(
                     gpNote.myGraceNote->myDuration));
             }
@@ -423,7 +422,7 @@ int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
         if (!gracePos.getNotes().empty())
         {
             gracePos.setProperty(Position::Acciaccatura);
-            voice.insertPosition(gracePos);
+            voice.insertPosition(std::move(gracePos));
             ++position;
         }
     }
@@ -501,7 +500,7 @@ int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
         hasPalmMutedNote |= gp_note.myHasPalmMute;
         hasLetRingNote |= gp_note.myIsLetRing;
 
-        pos.insertNote(note);
+        pos.insertNote(std::move(note));
     }
 
     pos.setProperty(Position::Vibrato, hasVibratoNote);
@@ -512,7 +511,7 @@ int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
     pos.setProperty(Position::PalmMuting, hasPalmMutedNote);
     pos.setProperty(Position::LetRing, hasLetRingNote);
 
-    voice.insertPosition(pos);
+    voice.insertPosition(std::move(pos));
     return position + 1;
 }
 
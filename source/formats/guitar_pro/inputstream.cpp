@@ -31,11 +31,9 @@ const std::map<std::string, Gp::Version> theVersionStrings = {
     { "FICHIER GUITAR PRO v5.10", Gp::Version5_1 }
 };
 
-Gp::InputStream::InputStream(std::istream &stream) : myStream(stream)
+Gp::InputStream::InputStream(const uint8_t *data, size_t size)
+    : myReader(data, size)
 {
-    myStream.exceptions(std::istream::failbit | std::istream::badbit |
-                       std::istream::eofbit);
-
     const std::string versionString = readVersionString();
 
     auto it = theVersionStrings.find(versionString);
@@ -47,14 +45,14 @@ Gp::InputStream::InputStream(std::istream &stream) : myStream(stream)
 
 std::string Gp::InputStream::readVersionString()
 {
-    myStream.seekg(std::ios_base::beg);
+    myReader.seek(0);
 
     // THe version consists of a 30 character string, although not all 30
     // characters may be used.
     std::string version = readCharacterString<uint8_t>();
 
     // Skip past any unread characters to land at position 0x1f.
-    myStream.seekg(31, std::ios_base::beg);
+    myReader.seek(31);
 
     return version;
 }
@@ -78,21 +76,13 @@ std::string Gp::InputStream::readFixedLengthString(uint32_t maxLength)
 {
     const uint8_t actualLength = read<uint8_t>();
 
-    std::string str;
-
-    if (maxLength != 0)
-        str.resize(maxLength);
-    else
-        str.resize(actualLength);
+    const boost::string_ref str =
+        myReader.readString(maxLength != 0 ? maxLength : actualLength);
 
-    if (str.size() != 0)
-        myStream.read(&str[0], str.size());
-
-    str.resize(actualLength);
-    return str;
+    return str.substr(0, actualLength).to_string();
 }
 
 void Gp::InputStream::skip(int numBytes)
 {
-    myStream.seekg(numBytes, std::ios_base::cur);
+    myReader.skip(numBytes);
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "mappedfile.h"
+
+#include <boost/filesystem/operations.hpp>
+
+MappedFile::MappedFile(const boost::filesystem::path &filename)
+{
+    // Empty files cannot be mapped, but are otherwise valid.
+    if (boost::filesystem::file_size(filename) != 0)
+        myFile.open(filename);
+}
+
+const uint8_t *MappedFile::data() const
+{
+    static const uint8_t theEmptyData[1] = {};
+
+    if (!myFile.is_open())
+        return theEmptyData;
+
+    return reinterpret_cast<const uint8_t *>(myFile.data());
+}
+
+size_t MappedFile::size() const
+{
+    return myFile.is_open() ? myFile.size() : 0;
+}
@@ -0,0 +1,40 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef FORMATS_MAPPEDFILE_H
+#define FORMATS_MAPPEDFILE_H
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdint>
+
+/// Provides read-only access to the contents of a file by mapping it into
+/// memory, so that importers can parse it without any copying or buffering.
+class MappedFile
+{
+public:
+    /// @throw std::ios_base::failure if the file cannot be opened.
+    explicit MappedFile(const boost::filesystem::path &filename);
+
+    const uint8_t *data() const;
+    size_t size() const;
+
+private:
+    boost::iostreams::mapped_file_source myFile;
+};
+
+#endif
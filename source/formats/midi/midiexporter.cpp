@@ -19,65 +19,10 @@
 
 #include <app/settingsmanager.h>
 #include <audio/settings.h>
-#include <midi/midifile.h>
+#include <formats/midi/midifilewriter.h>
 #include <score/generalmidi.h>
 
-#include <array>
 #include <boost/filesystem/fstream.hpp>
-#include <cstdint>
-
-// For htonl.
-#ifdef _WIN32
-#include <WinSock2.h>
-#else
-#include <arpa/inet.h>
-#endif
-
-static uint32_t toBigEndian(uint32_t val)
-{
-    return htonl(val);
-}
-
-static uint16_t toBigEndian(uint16_t val)
-{
-    return htons(val);
-}
-
-static uint8_t toBigEndian(uint8_t val)
-{
-    return val;
-}
-
-template <typename T>
-static void write(std::ostream &os, T val)
-{
-    val = toBigEndian(val);
-    os.write(reinterpret_cast<const char *>(&val), sizeof(T));
-}
-
-static void writeVariableLength(std::ostream &os, uint32_t val)
-{
-    std::array<uint8_t, 5> bytes;
-    for (int i = 0; i < 5; ++i)
-        bytes[i] = (val >> ((4 - i) * 7)) & 0x7f;
-
-    // Find the first byte that needs to be written.
-    int i = 0;
-    for (i = 0; i < 4; ++i)
-    {
-        if (bytes[i] != 0)
-            break;
-    }
-
-    for (; i < 5; ++i)
-    {
-        // Set the top bit to indicate that more bytes will follow it.
-        if (i < 4)
-            bytes[i] |= 0x80;
-
-        write(os, bytes[i]);
-    }
-}
 
 MidiExporter::MidiExporter(const SettingsManager &settings_manager)
     : FileFormatExporter(FileFormat("MIDI File", { "mid" })),
@@ -105,52 +50,6 @@ void MidiExporter::save(const boost::filesystem::path &filename, const Score &sc
             settings->get(Settings::MidiWideVibratoLevel);
     }
 
-    MidiFile file;
-    file.load(score, options);
-    writeHeader(os, file);
-
-    for (const MidiEventList &track : file.getTracks())
-        writeTrack(os, track);
-}
-
-void MidiExporter::writeHeader(std::ostream &os, const MidiFile &file)
-{
-    // Chunk ID for the header chunk.
-    os << "MThd";
-    // 6 bytes will follow the chunk size.
-    write(os, static_cast<uint32_t>(6));
-
-    // A format type of 1 indicates that we'll have multiple tracks.
-    write(os, static_cast<uint16_t>(1));
-    write(os, static_cast<uint16_t>(file.getTracks().size()));
-
-    // Time division.
-    write(os, static_cast<uint16_t>(file.getTicksPerBeat()));
-}
-
-void MidiExporter::writeTrack(std::ostream & os, const MidiEventList & events)
-{
-    // Chunk ID for a track chunk.
-    os << "MTrk";
-
-    // Size in bytes of the track chunk. This will be updated after writing out
-    // all of the data.
-    const std::iostream::pos_type chunk_len_pos = os.tellp();
-    write(os, static_cast<uint32_t>(0));
-
-    // Write out the MIDI events.
-    const std::iostream::pos_type chunk_start_pos = os.tellp();
-    for (const MidiEvent &event : events)
-    {
-        writeVariableLength(os, event.getTicks());
-        os.write(reinterpret_cast<const char *>(event.getData().data()),
-                 event.getData().size());
-    }
-
-    const std::iostream::pos_type chunk_end_pos = os.tellp();
-
-    // Record the size in bytes of the track chunk.
-    os.seekp(chunk_len_pos);
-    write(os, static_cast<uint32_t>(chunk_end_pos - chunk_start_pos));
-    os.seekp(chunk_end_pos);
+    MidiFileWriter writer(os);
+    writer.write(score, options);
 }
@@ -20,9 +20,6 @@
 
 #include <formats/fileformatmanager.h>
 
-class MidiEventList;
-class MidiFile;
-
 class MidiExporter : public FileFormatExporter
 {
 public:
@@ -32,9 +29,6 @@ public:
                       const Score &score) override;
 
 private:
-    static void writeHeader(std::ostream &os, const MidiFile &file);
-    static void writeTrack(std::ostream &os, const MidiEventList &events);
-
     const SettingsManager &mySettingsManager;
 };
 
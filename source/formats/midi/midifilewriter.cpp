@@ -0,0 +1,204 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "midifilewriter.h"
+
+#include <midi/midievent.h>
+#include <midi/midieventlist.h>
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+/// The size of the chunk ID and length fields.
+static const size_t CHUNK_HEADER_SIZE = 8;
+
+template <typename T>
+static void writeBigEndian(std::vector<uint8_t> &data, size_t offset, T val)
+{
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        data[offset + i] =
+            static_cast<uint8_t>(val >> ((sizeof(T) - 1 - i) * 8));
+    }
+}
+
+template <typename T>
+static void appendBigEndian(std::vector<uint8_t> &data, T val)
+{
+    data.resize(data.size() + sizeof(T));
+    writeBigEndian(data, data.size() - sizeof(T), val);
+}
+
+MidiTrackEncoder::MidiTrackEncoder() : myRunningStatus(0), myLastTick(0)
+{
+    // Chunk ID for a track chunk, followed by the chunk length which is filled
+    // in by getData().
+    myData = { 'M', 'T', 'r', 'k', 0, 0, 0, 0 };
+}
+
+void MidiTrackEncoder::reserve(size_t num_events)
+{
+    // Most events are channel messages with a one byte delta time.
+    myData.reserve(myData.size() + num_events * 4);
+}
+
+void MidiTrackEncoder::append(uint32_t delta_ticks, const MidiEvent &event)
+{
+    writeVariableLength(delta_ticks);
+
+    const uint8_t *data = event.getData();
+    const uint8_t *data_end = data + event.getDataSize();
+    const uint8_t status = event.getStatusByte();
+
+    if (status < MidiEvent::SysEx)
+    {
+        // The status byte can be omitted if it is the same as the previous
+        // channel message.
+        if (status == myRunningStatus)
+            ++data;
+
+        myRunningStatus = status;
+    }
+    else
+    {
+        // System exclusive and meta events cancel running status.
+        myRunningStatus = 0;
+
+        // System exclusive messages have their length stored after the status
+        // byte.
+        if (status == MidiEvent::SysEx)
+        {
+            myData.push_back(status);
+            ++data;
+            writeVariableLength(static_cast<uint32_t>(data_end - data));
+        }
+    }
+
+    myData.insert(myData.end(), data, data_end);
+}
+
+void MidiTrackEncoder::appendBefore(MidiEventList &events, int end_tick)
+{
+    events.sort();
+
+    for (const MidiEvent &event : events)
+    {
+        if (event.getTicks() >= end_tick)
+            break;
+
+        // An event before the events that were already written out can't be
+        // encoded, since it would need a negative delta.
+        if (event.getTicks() < myLastTick)
+            throw std::logic_error("MIDI event is out of order");
+
+        append(static_cast<uint32_t>(event.getTicks() - myLastTick), event);
+        myLastTick = event.getTicks();
+    }
+
+    events.removeBefore(end_tick);
+}
+
+const std::vector<uint8_t> &MidiTrackEncoder::getData()
+{
+    writeBigEndian(myData, 4,
+                   static_cast<uint32_t>(myData.size() - CHUNK_HEADER_SIZE));
+    return myData;
+}
+
+void MidiTrackEncoder::writeVariableLength(uint32_t val)
+{
+    // Find the number of 7-bit groups that are needed.
+    int num_bytes = 1;
+    while (num_bytes < 5 && (val >> (7 * num_bytes)) != 0)
+        ++num_bytes;
+
+    for (int i = num_bytes - 1; i >= 0; --i)
+    {
+        uint8_t byte = (val >> (7 * i)) & 0x7f;
+        // Set the top bit to indicate that more bytes will follow it.
+        if (i > 0)
+            byte |= 0x80;
+
+        myData.push_back(byte);
+    }
+}
+
+MidiFileWriter::MidiFileWriter(std::ostream &os) : myStream(os)
+{
+}
+
+void MidiFileWriter::write(const MidiFile &file)
+{
+    writeHeader(file.getTracks().size(), file.getTicksPerBeat());
+
+    for (const MidiEventList &events : file.getTracks())
+    {
+        MidiTrackEncoder encoder;
+        encoder.reserve(events.size());
+
+        for (const MidiEvent &event : events)
+            encoder.append(static_cast<uint32_t>(event.getTicks()), event);
+
+        writeTrack(encoder);
+    }
+}
+
+void MidiFileWriter::write(const Score &score,
+                           const MidiFile::LoadOptions &options)
+{
+    // Since the tracks are written one after another, each track must be
+    // finished before it is written out. The encoded tracks are much smaller
+    // than the generated events, though.
+    std::vector<MidiTrackEncoder> encoders;
+
+    MidiFile file;
+    file.stream(score, options,
+                [&](const std::vector<MidiEventList *> &tracks,
+                    int complete_tick)
+    {
+        encoders.resize(tracks.size());
+        for (size_t i = 0; i < tracks.size(); ++i)
+            encoders[i].appendBefore(*tracks[i], complete_tick);
+    });
+
+    writeHeader(encoders.size(), file.getTicksPerBeat());
+    for (MidiTrackEncoder &encoder : encoders)
+        writeTrack(encoder);
+}
+
+void MidiFileWriter::writeHeader(size_t num_tracks, int ticks_per_beat)
+{
+    // Chunk ID for the header chunk.
+    std::vector<uint8_t> data = { 'M', 'T', 'h', 'd' };
+    // 6 bytes will follow the chunk size.
+    appendBigEndian(data, static_cast<uint32_t>(6));
+
+    // A format type of 1 indicates that we'll have multiple tracks.
+    appendBigEndian(data, static_cast<uint16_t>(1));
+    appendBigEndian(data, static_cast<uint16_t>(num_tracks));
+
+    // Time division.
+    appendBigEndian(data, static_cast<uint16_t>(ticks_per_beat));
+
+    myStream.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+void MidiFileWriter::writeTrack(MidiTrackEncoder &encoder)
+{
+    const std::vector<uint8_t> &data = encoder.getData();
+    myStream.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
@@ -0,0 +1,83 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef FORMATS_MIDIFILEWRITER_H
+#define FORMATS_MIDIFILEWRITER_H
+
+#include <midi/midifile.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+class MidiEvent;
+class MidiEventList;
+class Score;
+
+/// Encodes a track chunk of a Standard MIDI File into a contiguous buffer.
+/// Consecutive channel messages with the same status byte are written using
+/// running status.
+class MidiTrackEncoder
+{
+public:
+    MidiTrackEncoder();
+
+    /// Reserves space for the given number of events.
+    void reserve(size_t num_events);
+
+    /// Appends an event that occurs the given number of ticks after the
+    /// previous event.
+    void append(uint32_t delta_ticks, const MidiEvent &event);
+
+    /// Appends the events (using absolute ticks) that occur before the given
+    /// tick, and removes them from the list. Throws std::logic_error if an
+    /// event occurs before the events that were previously appended.
+    void appendBefore(MidiEventList &events, int end_tick);
+
+    /// Returns the encoded chunk, including its header.
+    const std::vector<uint8_t> &getData();
+
+private:
+    void writeVariableLength(uint32_t val);
+
+    std::vector<uint8_t> myData;
+    uint8_t myRunningStatus;
+    /// The absolute tick of the last event added by appendBefore().
+    int myLastTick;
+};
+
+/// Writes a Standard MIDI File. Each chunk is encoded in memory and written to
+/// the stream with a single call.
+class MidiFileWriter
+{
+public:
+    explicit MidiFileWriter(std::ostream &os);
+
+    /// Writes out a file whose events have already been generated.
+    void write(const MidiFile &file);
+
+    /// Generates and writes out the events for the score one system at a
+    /// time, so that only the encoded tracks are kept in memory.
+    void write(const Score &score, const MidiFile::LoadOptions &options);
+
+private:
+    void writeHeader(size_t num_tracks, int ticks_per_beat);
+    void writeTrack(MidiTrackEncoder &encoder);
+
+    std::ostream &myStream;
+};
+
+#endif
@@ -21,11 +21,12 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
+#include <score/binaryserialization.h>
 #include <score/score.h>
 #include <score/serialization.h>
 
-PowerTabExporter::PowerTabExporter()
-    : FileFormatExporter(getPowerTabFileFormat())
+PowerTabExporter::PowerTabExporter(Encoding encoding)
+    : FileFormatExporter(getPowerTabFileFormat()), myEncoding(encoding)
 {
 }
 
@@ -40,5 +41,8 @@ void PowerTabExporter::save(const boost::filesystem::path &filename,
     out.push(file);
 
     std::ostream compressed_output(&out);
-    ScoreUtils::save(compressed_output, "score", score);
+    if (myEncoding == Encoding::Binary)
+        ScoreUtils::saveBinary(compressed_output, "score", score);
+    else
+        ScoreUtils::save(compressed_output, "score", score);
 }
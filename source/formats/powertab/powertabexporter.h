@@ -23,10 +23,21 @@
 class PowerTabExporter : public FileFormatExporter
 {
 public:
-    PowerTabExporter();
+    /// The encoding used for the score data. The data is compressed with
+    /// gzip in either case, and the importer accepts both encodings.
+    enum class Encoding
+    {
+        Json,
+        Binary
+    };
+
+    PowerTabExporter(Encoding encoding = Encoding::Json);
 
     virtual void save(const boost::filesystem::path &filename,
                       const Score &score) override;
+
+private:
+    const Encoding myEncoding;
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <score/binaryserialization.h>
 #include <score/score.h>
 #include <score/serialization.h>
 
@@ -41,5 +42,8 @@ void PowerTabImporter::load(const boost::filesystem::path &filename,
     in.push(file);
 
     std::istream compressed_input(&in);
-    ScoreUtils::load(compressed_input, "score", score);
+    if (ScoreUtils::isBinaryArchive(compressed_input))
+        ScoreUtils::loadBinary(compressed_input, "score", score);
+    else
+        ScoreUtils::load(compressed_input, "score", score);
 }
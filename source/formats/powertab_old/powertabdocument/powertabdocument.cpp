@@ -14,6 +14,7 @@
 #include "powertaboutputstream.h"
 
 #include <boost/filesystem/fstream.hpp>
+#include <formats/mappedfile.h>
 
 #include "score.h"
 
@@ -216,12 +217,11 @@ bool Document::Save(const PathType& fileName) const
 
 /// Loads a power tab file.
 /// @param fileName Full path of the file to load.
-/// @throw std::ifstream::failure
+/// @throw std::runtime_error
 void Document::Load(const boost::filesystem::path& fileName)
 {
-    boost::filesystem::ifstream fileStream(fileName, std::ifstream::in |
-                                                         std::ifstream::binary);
-    PowerTabInputStream stream(fileStream);
+    const MappedFile file(fileName);
+    PowerTabInputStream stream(file.data(), file.size());
 
     DeleteContents();
 
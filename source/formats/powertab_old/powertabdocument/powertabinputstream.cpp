@@ -18,11 +18,9 @@ namespace PowerTabDocument {
 
 using std::string;
 
-PowerTabInputStream::PowerTabInputStream(std::istream& stream) :
-    m_stream(stream)
+PowerTabInputStream::PowerTabInputStream(const uint8_t* data, size_t size) :
+    m_reader(data, size)
 {
-    // ensure that the stream will throw std::ifstream::failure if any errors occur
-    stream.exceptions(std::istream::failbit | std::istream::badbit | std::istream::eofbit);
 }
 
 // Read Functions
@@ -51,15 +49,9 @@ uint32_t PowerTabInputStream::ReadCount()
 /// @return True if the string was read, false if not
 void PowerTabInputStream::ReadMFCString(string& str)
 {
-    str.clear();
-
     const uint32_t length = ReadMFCStringLength();
-    str.resize(length);
-
-	if (length != 0)
-	{
-		m_stream.read(&str[0], length);
-	}
+    const boost::string_ref data = m_reader.readString(length);
+    str.assign(data.data(), data.size());
 }
 
 /// Reads a Win32 format COLORREF type from the stream
@@ -129,7 +121,7 @@ void PowerTabInputStream::ReadClassInformation()
 
         *this >> schema;
         *this >> length;
-        m_stream.seekg(length, std::ios_base::cur);
+        m_reader.skip(length);
     }
 
     // otherwise, existing class index in obj_tag followed by new object
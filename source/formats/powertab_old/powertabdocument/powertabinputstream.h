@@ -14,8 +14,9 @@
 
 #include <array>
 #include <cstdint>
-#include <istream>
+#include <formats/bytereader.h>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace PowerTabDocument {
@@ -28,10 +29,11 @@ class PowerTabInputStream
 {
     // Member Variables
 private:
-    std::istream& m_stream;
+    ByteReader m_reader;
 
 public:
-    PowerTabInputStream(std::istream& stream);
+    /// The data (typically a memory-mapped file) must outlive the stream.
+    PowerTabInputStream(const uint8_t* data, size_t size);
 
     // Read Functions
     uint32_t ReadCount();
@@ -61,11 +63,11 @@ public:
     }
 
     /// Read data from the input stream
-    /// @throw std::ifstream::failure if any errors occur
+    /// @throw FileFormatException if the end of the file is reached
     template<class T>
     inline PowerTabInputStream& operator>>(T& data)
     {
-        m_stream.read(reinterpret_cast<char *>(&data), sizeof(data));
+        data = m_reader.read<T>();
         return *this;
     }
 
@@ -78,7 +80,8 @@ public:
         vect.clear();
         vect.resize(size);
 
-        m_stream.read((char*)&vect[0], size * sizeof(T));
+        for (T& item : vect)
+            *this >> item;
     }
 
     template <class T, size_t N>
@@ -87,7 +90,11 @@ public:
         uint8_t size = 0;
         *this >> size;
 
-        m_stream.read((char*)&array[0], size * sizeof(T));
+        if (size > N)
+            throw std::runtime_error("Invalid array size");
+
+        for (size_t i = 0; i < size; ++i)
+            *this >> array[i];
     }
 
 private:
@@ -38,17 +38,35 @@
 #include <score/utils/scoremerger.h>
 #include <score/utils/scorepolisher.h>
 
+#include <future>
+
 PowerTabOldImporter::PowerTabOldImporter()
     : FileFormatImporter(FileFormat("Power Tab 1.7 Document", { "ptb" }))
 {
 }
 
+void PowerTabOldImporter::setTimingCallback(const TimingCallback &callback)
+{
+    myTimingCallback = callback;
+}
+
+void PowerTabOldImporter::reportStageTime(const char *stage,
+                                          Clock::duration elapsed) const
+{
+    if (myTimingCallback)
+        myTimingCallback(stage, elapsed);
+}
+
 void PowerTabOldImporter::load(const boost::filesystem::path &filename,
                                Score &score)
 {
+    Clock::time_point start = Clock::now();
+
     PowerTabDocument::Document document;
     document.Load(filename);
 
+    reportStageTime("reading the document", Clock::now() - start);
+
     // TODO - handle font settings, etc.
     ScoreInfo info;
     convert(document.GetHeader(), info);
@@ -58,18 +76,36 @@ void PowerTabOldImporter::load(const boost::filesystem::path &filename,
     
     assert(document.GetNumberOfScores() == 2);
 
-    // Convert the guitar score.
+    // The guitar and bass scores are independent, so convert the guitar score
+    // in the background while converting the bass score.
     Score guitarScore;
-    convert(*document.GetScore(0), guitarScore);
+    std::future<Clock::duration> guitarTask =
+        std::async(std::launch::async, [&]() {
+            const Clock::time_point task_start = Clock::now();
+            convert(*document.GetScore(0), guitarScore);
+            return Clock::now() - task_start;
+        });
 
-    // Convert and then merge the bass score.
     Score bassScore;
+    const Clock::time_point bass_start = Clock::now();
     convert(*document.GetScore(1), bassScore);
+    const Clock::duration bass_time = Clock::now() - bass_start;
+
+    const Clock::duration guitar_time = guitarTask.get();
+    reportStageTime("converting the guitar score", guitar_time);
+    reportStageTime("converting the bass score", bass_time);
+
+    Clock::time_point stage_start = Clock::now();
     ScoreMerger::merge(score, guitarScore, bassScore);
+    reportStageTime("merging", Clock::now() - stage_start);
 
     // Reformat the score, since the guitar and bass score from v1.7 may have
     // had different spacing.
+    stage_start = Clock::now();
     ScoreUtils::polishScore(score);
+    reportStageTime("polishing", Clock::now() - stage_start);
+
+    reportStageTime("the import", Clock::now() - start);
 }
 
 void PowerTabOldImporter::convert(
@@ -156,7 +192,7 @@ void PowerTabOldImporter::convert(const PowerTabDocument::Score &oldScore,
     {
         System system;
         convert(oldScore, oldScore.GetSystem(i), system);
-        score.insertSystem(system);
+        score.insertSystem(std::move(system));
     }
 
     // Convert Guitar In's to player changes.
@@ -292,7 +328,7 @@ void PowerTabOldImporter::convert(const PowerTabDocument::Score &oldScore,
         Staff staff;
         int lastPosInStaff = convert(*oldSystem->GetStaff(i), dynamicsInStaff,
                                      staff);
-        system.insertStaff(staff);
+        system.insertStaff(std::move(staff));
         lastPosition = std::max(lastPosition, lastPosInStaff);
     }
 
@@ -589,8 +625,8 @@ int PowerTabOldImporter::convert(
         {
             Position position;
             convert(*oldStaff.GetPosition(voice, i), position);
-            staff.getVoices()[voice].insertPosition(position);
             lastPosition = std::max(position.getPosition(), lastPosition);
+            staff.getVoices()[voice].insertPosition(std::move(position));
         }
     }
 
@@ -705,7 +741,7 @@ void PowerTabOldImporter::convert(const PowerTabDocument::Position &oldPosition,
     {
         Note note;
         convert(*oldPosition.GetNote(i), note);
-        position.insertNote(note);
+        position.insertNote(std::move(note));
     }
 }
 
@@ -882,6 +918,10 @@ void PowerTabOldImporter::convertGuitarIns(
         score.getSystems()[i].insertPlayerChange(
             getPlayerChange(activePlayers, static_cast<int>(currentPosition)));
     }
+
+    // The player changes were added directly to the systems, so the score's
+    // index needs to be rebuilt.
+    score.updatePlayerChangeIndex(0);
 }
 
 void PowerTabOldImporter::convertInitialVolumes(
@@ -18,7 +18,9 @@
 #ifndef FORMATS_POWERTABOLDIMPORTER_H
 #define FORMATS_POWERTABOLDIMPORTER_H
 
+#include <chrono>
 #include <formats/fileformat.h>
+#include <functional>
 #include <memory>
 
 namespace PowerTabDocument {
@@ -60,10 +62,19 @@ class Tuning;
 class PowerTabOldImporter : public FileFormatImporter
 {
 public:
+    typedef std::chrono::steady_clock Clock;
+    /// Receives the time taken by a stage of the import.
+    typedef std::function<void(const char *stage, Clock::duration elapsed)>
+        TimingCallback;
+
     PowerTabOldImporter();
     virtual void load(const boost::filesystem::path &filename,
                       Score &score) override;
 
+    /// Reports how long each stage of the import takes (e.g. for the
+    /// benchmarks). By default, the times are not reported.
+    void setTimingCallback(const TimingCallback &callback);
+
 private:
     static void convert(const PowerTabDocument::PowerTabFileHeader &header,
                         ScoreInfo &info);
@@ -115,6 +126,10 @@ private:
                                     Score &score);
 
     static void merge(Score &score1, Score &score2);
+
+    void reportStageTime(const char *stage, Clock::duration elapsed) const;
+
+    TimingCallback myTimingCallback;
 };
 
 #endif
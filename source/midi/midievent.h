@@ -20,12 +20,21 @@
 
 #include <score/systemlocation.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+#include <initializer_list>
 
+/// A MIDI message at a point in time. The message bytes are stored inline
+/// rather than in a separate allocation, since a score can produce a very
+/// large number of events.
 class MidiEvent
 {
 public:
+    /// The maximum size of a message. This is large enough for all of the
+    /// messages that are generated, the largest of which is a tempo change.
+    static const size_t MAX_DATA_SIZE = 6;
+
     enum StatusByte : uint8_t
     {
         NoteOff = 0x80,
@@ -37,6 +46,17 @@ public:
         MetaMessage = 0xff
     };
 
+    enum Controller : uint8_t
+    {
+        ModWheel = 0x01,
+        DataEntryCoarse = 0x06,
+        ChannelVolume = 0x07,
+        DataEntryFine = 0x26,
+        HoldPedal = 0x40,
+        RpnLsb = 0x64,
+        RpnMsb = 0x65
+    };
+
     inline bool operator<(const MidiEvent &other) const
     {
         return myTicks < other.myTicks;
@@ -45,7 +65,9 @@ public:
     int getTicks() const { return myTicks; }
     void setTicks(int ticks) { myTicks = ticks; }
     uint8_t getStatusByte() const { return myData[0]; }
-    const std::vector<uint8_t> &getData() const { return myData; }
+    /// Returns the message bytes, which includes the status byte.
+    const uint8_t *getData() const { return myData.data(); }
+    size_t getDataSize() const { return myDataSize; }
     const SystemLocation &getLocation() const { return myLocation; }
 
     bool isTempoChange() const;
@@ -53,7 +75,12 @@ public:
     bool isProgramChange() const;
     bool isPositionChange() const;
     bool isNoteOnOff() const;
+    /// Returns whether this is a message for a channel, such as a note or a
+    /// controller change.
+    bool isChannelMessage() const { return getStatusByte() < SysEx; }
     uint8_t getChannel() const;
+    /// Returns the status byte without the channel.
+    uint8_t getMessageType() const;
 
     static MidiEvent endOfTrack(int ticks);
     static MidiEvent setTempo(int ticks, int microseconds);
@@ -67,19 +94,17 @@ public:
     static MidiEvent holdPedal(int ticks, uint8_t channel, bool enabled);
     static MidiEvent pitchWheel(int ticks, uint8_t channel, uint8_t amount);
     static MidiEvent positionChange(int ticks, const SystemLocation &location);
-    static std::vector<MidiEvent> pitchWheelRange(int ticks, uint8_t channel,
-                                                  uint8_t semitones);
+    static std::array<MidiEvent, 4> pitchWheelRange(int ticks, uint8_t channel,
+                                                    uint8_t semitones);
 
 private:
-    MidiEvent(int ticks, std::vector<uint8_t> data,
-              const SystemLocation &location, int player, int instrument);
+    MidiEvent(int ticks, std::initializer_list<uint8_t> data,
+              const SystemLocation &location);
 
     int myTicks; // TODO - does this need to be 64-bit for absolute times?
-    std::vector<uint8_t> myData;
-
     SystemLocation myLocation;
-    int myPlayer;
-    int myInstrument;
+    std::array<uint8_t, MAX_DATA_SIZE> myData;
+    uint8_t myDataSize;
 };
 
 #endif
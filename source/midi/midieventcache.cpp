@@ -0,0 +1,103 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "midieventcache.h"
+
+#include <midi/miditimeline.h>
+#include <score/utils/playbackorder.h>
+
+void MidiEventCache::invalidateSystem(int system)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    for (int i = system - 1; i <= system + 1; ++i)
+        mySystems.erase(i);
+
+    // Any edit could change the bars that are repeated.
+    myPlaybackOrder.reset();
+    myTimeline.reset();
+}
+
+void MidiEventCache::clear()
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    mySystems.clear();
+    myPlaybackOrder.reset();
+    myTimeline.reset();
+}
+
+void MidiEventCache::setOptions(const MidiFile::LoadOptions &options)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if (!myOptions || !myOptions->generatesSameEvents(options))
+    {
+        mySystems.clear();
+        myTimeline.reset();
+        myOptions = options;
+    }
+}
+
+std::shared_ptr<const MidiFile::BarEvents> MidiEventCache::find(
+    int system, int bar, const MidiFile::BarState &state) const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    auto system_it = mySystems.find(system);
+    if (system_it == mySystems.end())
+        return nullptr;
+
+    auto range = system_it->second.equal_range(bar);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second->myStartState == state)
+            return it->second;
+    }
+
+    return nullptr;
+}
+
+void MidiEventCache::insert(
+    int system, int bar, const std::shared_ptr<const MidiFile::BarEvents> &events)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    mySystems[system].emplace(bar, events);
+}
+
+std::shared_ptr<const PlaybackOrder> MidiEventCache::getPlaybackOrder(
+    const Score &score)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if (!myPlaybackOrder)
+        myPlaybackOrder = std::make_shared<const PlaybackOrder>(score);
+
+    return myPlaybackOrder;
+}
+
+std::shared_ptr<const MidiTimeline> MidiEventCache::getTimeline() const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    return myTimeline;
+}
+
+void MidiEventCache::setTimeline(
+    const std::shared_ptr<const MidiTimeline> &timeline)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    myTimeline = timeline;
+}
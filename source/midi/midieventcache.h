@@ -0,0 +1,78 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef MIDI_MIDIEVENTCACHE_H
+#define MIDI_MIDIEVENTCACHE_H
+
+#include <boost/optional/optional.hpp>
+#include <map>
+#include <memory>
+#include <midi/midifile.h>
+#include <mutex>
+
+class MidiTimeline;
+class PlaybackOrder;
+
+/// Caches the MIDI events that were generated for each bar of a score, so that
+/// MidiFile::load() only needs to regenerate the bars that were edited.
+/// The cache must be invalidated whenever the score is modified.
+class MidiEventCache
+{
+public:
+    /// Removes the cached events for the given system. Since notes can be
+    /// tied between systems, the adjacent systems are also invalidated.
+    void invalidateSystem(int system);
+    /// Removes all cached events.
+    void clear();
+
+    /// Removes all cached events if they were generated with different
+    /// options.
+    void setOptions(const MidiFile::LoadOptions &options);
+
+    /// Returns the cached events for the bar if they were generated from the
+    /// same starting state.
+    std::shared_ptr<const MidiFile::BarEvents> find(
+        int system, int bar, const MidiFile::BarState &state) const;
+    /// Adds the events for a bar to the cache.
+    void insert(int system, int bar,
+                const std::shared_ptr<const MidiFile::BarEvents> &events);
+
+    /// Returns the order in which the score's bars are played, which is only
+    /// computed again after the cache is invalidated.
+    std::shared_ptr<const PlaybackOrder> getPlaybackOrder(const Score &score);
+
+    /// Returns the timeline for playing the entire score, if it has been
+    /// generated since the cache was last invalidated.
+    std::shared_ptr<const MidiTimeline> getTimeline() const;
+    /// Stores the timeline for the entire score, so that later playback can
+    /// begin at any bar without regenerating the events.
+    void setTimeline(const std::shared_ptr<const MidiTimeline> &timeline);
+
+private:
+    mutable std::mutex myMutex;
+    boost::optional<MidiFile::LoadOptions> myOptions;
+    /// Cached bars for each system, indexed by the bar's position. A bar may
+    /// be played several times with a different starting state (e.g. a
+    /// repeated section with a tempo change).
+    std::map<int,
+             std::multimap<int, std::shared_ptr<const MidiFile::BarEvents>>>
+        mySystems;
+    std::shared_ptr<const PlaybackOrder> myPlaybackOrder;
+    std::shared_ptr<const MidiTimeline> myTimeline;
+};
+
+#endif
@@ -19,28 +19,25 @@
 
 #include <algorithm>
 #include <cassert>
+#include <queue>
+#include <utility>
 
 MidiEventList::MidiEventList(bool absolute_ticks)
-    : myAbsoluteTicks(absolute_ticks)
+    : myFirstEvent(0), myAbsoluteTicks(absolute_ticks)
 {
 }
 
 void MidiEventList::convertToDeltaTicks()
 {
-    assert(myAbsoluteTicks);
+    // First, sort by timestamp. Events for different voices may have been added
+    // out of order.
+    sort();
+    compact();
     myAbsoluteTicks = false;
 
     if (myEvents.size() <= 1)
         return;
 
-    // First, sort by timestamp. Events for different voices may have been added
-    // out of order.
-    std::stable_sort(myEvents.begin(), myEvents.end(),
-                     [](const MidiEvent &a, const MidiEvent &b)
-                     {
-                         return a.getTicks() < b.getTicks();
-                     });
-
     for (size_t i = myEvents.size() - 1; i >= 1; --i)
     {
         MidiEvent &event = myEvents[i];
@@ -53,6 +50,7 @@ void MidiEventList::convertToAbsoluteTicks()
 {
     assert(!myAbsoluteTicks);
     myAbsoluteTicks = true;
+    compact();
 
     for (size_t i = 1; i < myEvents.size(); ++i)
     {
@@ -61,9 +59,102 @@ void MidiEventList::convertToAbsoluteTicks()
     }
 }
 
-void MidiEventList::concat(const MidiEventList &other)
+void MidiEventList::sort()
+{
+    assert(myAbsoluteTicks);
+
+    auto compare = [](const MidiEvent &a, const MidiEvent &b)
+    {
+        return a.getTicks() < b.getTicks();
+    };
+
+    if (!std::is_sorted(begin(), end(), compare))
+        std::stable_sort(begin(), end(), compare);
+}
+
+void MidiEventList::removeBefore(int tick)
+{
+    assert(myAbsoluteTicks);
+
+    auto it = std::lower_bound(begin(), end(), tick,
+                               [](const MidiEvent &event, int t)
+    {
+        return event.getTicks() < t;
+    });
+    myFirstEvent = it - myEvents.begin();
+
+    // Erasing from the front of the vector moves all of the remaining events,
+    // so only do this once the removed events outnumber the remaining ones.
+    if (myFirstEvent > size())
+        compact();
+}
+
+void MidiEventList::compact()
+{
+    myEvents.erase(myEvents.begin(), myEvents.begin() + myFirstEvent);
+    myFirstEvent = 0;
+}
+
+void MidiEventList::concat(const MidiEventList &other, int tick_offset)
 {
-    myEvents.reserve(myEvents.size() + other.myEvents.size());
-    myEvents.insert(myEvents.end(), other.myEvents.begin(),
-                    other.myEvents.end());
+    // Don't reserve the exact size here, since this is called for every bar
+    // and would defeat the vector's geometric growth.
+    const size_t start = myEvents.size();
+    myEvents.insert(myEvents.end(), other.begin(), other.end());
+
+    if (tick_offset != 0)
+    {
+        assert(myAbsoluteTicks);
+
+        for (size_t i = start; i < myEvents.size(); ++i)
+            myEvents[i].setTicks(myEvents[i].getTicks() + tick_offset);
+    }
+}
+
+MidiEventList MidiEventList::merge(const std::vector<MidiEventList> &lists)
+{
+    MidiEventList merged;
+
+    size_t num_events = 0;
+    for (const MidiEventList &list : lists)
+    {
+        assert(list.myAbsoluteTicks);
+        num_events += list.size();
+    }
+    merged.myEvents.reserve(num_events);
+
+    // Keep a min-heap of the next event from each list.
+    typedef std::pair<size_t, size_t> Cursor;
+    auto compare = [&](const Cursor &a, const Cursor &b)
+    {
+        const int a_ticks = lists[a.first].myEvents[a.second].getTicks();
+        const int b_ticks = lists[b.first].myEvents[b.second].getTicks();
+
+        if (a_ticks != b_ticks)
+            return a_ticks > b_ticks;
+        else
+            return a.first > b.first;
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(compare)> heap(
+        compare);
+
+    for (size_t i = 0; i < lists.size(); ++i)
+    {
+        if (!lists[i].empty())
+            heap.push(Cursor(i, lists[i].myFirstEvent));
+    }
+
+    while (!heap.empty())
+    {
+        Cursor cursor = heap.top();
+        heap.pop();
+
+        const std::vector<MidiEvent> &events = lists[cursor.first].myEvents;
+        merged.myEvents.push_back(events[cursor.second]);
+
+        if (++cursor.second < events.size())
+            heap.push(cursor);
+    }
+
+    return merged;
 }
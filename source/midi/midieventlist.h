@@ -31,24 +31,48 @@ public:
     /// Convert the MIDI events from delta to absolute ticks.
     void convertToAbsoluteTicks();
 
+    /// Sorts the events (using absolute ticks) by time. Events with the same
+    /// timestamp are kept in the order that they were added.
+    void sort();
+    /// Removes the events (using absolute ticks) that occur before the given
+    /// tick. The list must be sorted. This takes amortized constant time per
+    /// removed event, so it can be called repeatedly while streaming events.
+    void removeBefore(int tick);
+
     void append(const MidiEvent &event) { myEvents.push_back(event); }
     void append(MidiEvent &&event)
     {
         myEvents.push_back(std::forward<MidiEvent>(event));
     }
 
-    void concat(const MidiEventList &other);
+    /// Appends the events from another list, optionally shifting them by the
+    /// given number of ticks.
+    void concat(const MidiEventList &other, int tick_offset = 0);
+
+    /// Merges several lists of events (using absolute ticks) that are each
+    /// sorted by time. Events with the same timestamp are ordered by their
+    /// list's index, so this is equivalent to a stable sort of the
+    /// concatenated lists.
+    static MidiEventList merge(const std::vector<MidiEventList> &lists);
+
+    size_t size() const { return myEvents.size() - myFirstEvent; }
+    bool empty() const { return size() == 0; }
 
     typedef std::vector<MidiEvent>::iterator iterator;
     typedef std::vector<MidiEvent>::const_iterator const_iterator;
 
-    iterator begin() { return myEvents.begin(); }
+    iterator begin() { return myEvents.begin() + myFirstEvent; }
     iterator end() { return myEvents.end(); }
-    const_iterator begin() const { return myEvents.begin(); }
+    const_iterator begin() const { return myEvents.begin() + myFirstEvent; }
     const_iterator end() const { return myEvents.end(); }
 
 private:
+    /// Discards the storage for the events that were removed.
+    void compact();
+
     std::vector<MidiEvent> myEvents;
+    /// The index of the first event in myEvents that hasn't been removed.
+    size_t myFirstEvent;
     bool myAbsoluteTicks;
 };
 
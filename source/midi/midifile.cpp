@@ -17,17 +17,19 @@
   
 #include "midifile.h"
 
-#include "repeatcontroller.h"
-
-#include <boost/rational.hpp>
+#include "midieventcache.h"
 
 #include <score/generalmidi.h>
 #include <score/score.h>
 #include <score/scorelocation.h>
 #include <score/systemlocation.h>
 #include <score/utils.h>
+#include <score/utils/playbackorder.h>
 #include <score/voiceutils.h>
 
+#include <algorithm>
+#include <limits>
+
 static const int PERCUSSION_CHANNEL = 9;
 static const int METRONOME_CHANNEL = PERCUSSION_CHANNEL;
 static const int DEFAULT_PPQ = 480;
@@ -36,14 +38,18 @@ static const int PITCH_BEND_RANGE = 24;
 static const int DEFAULT_BEND = 64;
 static const int SLIDE_OUT_STEPS = 5;
 
-/// Pitch bend amount to bend a note by a quarter tone.
-static const boost::rational<int> BEND_QUARTER_TONE(
-    (Midi::MAX_MIDI_CHANNEL_EFFECT_LEVEL - DEFAULT_BEND), 2 * PITCH_BEND_RANGE);
+/// Returns the pitch bend amount to bend a note by the given number of quarter
+/// tones.
+static int getBendAmount(int quarter_tones)
+{
+    return (DEFAULT_BEND * 2 * PITCH_BEND_RANGE +
+            quarter_tones *
+                (Midi::MAX_MIDI_CHANNEL_EFFECT_LEVEL - DEFAULT_BEND)) /
+           (2 * PITCH_BEND_RANGE);
+}
 
-static const int SLIDE_BELOW_BEND = boost::rational_cast<int>(
-    DEFAULT_BEND - SLIDE_OUT_STEPS * 2 * BEND_QUARTER_TONE);
-static const int SLIDE_ABOVE_BEND = boost::rational_cast<int>(
-    DEFAULT_BEND + SLIDE_OUT_STEPS * 2 * BEND_QUARTER_TONE);
+static const int SLIDE_BELOW_BEND = getBendAmount(-SLIDE_OUT_STEPS * 2);
+static const int SLIDE_ABOVE_BEND = getBendAmount(SLIDE_OUT_STEPS * 2);
 
 enum Velocity : uint8_t
 {
@@ -68,72 +74,58 @@ static int getChannel(const ActivePlayer &player)
     return getChannel(player.getPlayerNumber());
 }
 
-static bool findPositionChange(MidiEventList &event_list, int ticks,
-                               bool record_position_changes,
-                               RepeatController &repeat_controller,
-                               const SystemLocation &prev_location,
-                               SystemLocation &location)
+bool MidiFile::LoadOptions::generatesSameEvents(
+    const LoadOptions &other) const
 {
-    SystemLocation new_location;
-    if (repeat_controller.checkForRepeat(prev_location, location, new_location))
-    {
-        if (record_position_changes)
-        {
-            event_list.append(MidiEvent::positionChange(ticks, new_location));
-        }
-
-        location = new_location;
-        return true;
-    }
-
-    return false;
+    return myVibratoStrength == other.myVibratoStrength &&
+           myWideVibratoStrength == other.myWideVibratoStrength &&
+           myStrongAccentVel == other.myStrongAccentVel &&
+           myWeakAccentVel == other.myWeakAccentVel &&
+           myMetronomePreset == other.myMetronomePreset;
 }
 
-static SystemLocation moveToNextBar(MidiEventList &event_list, int ticks,
-                                    bool record_position_changes,
-                                    const System &system,
-                                    SystemLocation location, int next_bar_pos,
-                                    RepeatController &repeat_controller)
+MidiFile::BarState::BarState() : myTempo(0)
 {
-    SystemLocation prev_location = location;
-    SystemLocation new_location;
-
-    // Move to the next barline and follow any directions / repeats / alternate
-    // endings.
-    location.setPosition(next_bar_pos);
+}
 
-    if (findPositionChange(event_list, ticks, record_position_changes,
-                           repeat_controller, prev_location, location))
-    {
-        return location;
-    }
+bool MidiFile::BarState::operator==(const BarState &other) const
+{
+    return myTempo == other.myTempo && myActiveBends == other.myActiveBends &&
+           myPlayers == other.myPlayers;
+}
 
-    // If we're at the end of the system, shift to the next system and also
-    // check for a position change there.
-    if (next_bar_pos == system.getBarlines().back().getPosition())
-    {
-        location.setSystem(location.getSystem() + 1);
-        location.setPosition(0);
+MidiFile::BarEvents::BarEvents() : myDuration(0), myFirstTick(0)
+{
+}
 
-        if (findPositionChange(event_list, ticks, record_position_changes,
-                               repeat_controller, prev_location, location))
-        {
-            return location;
-        }
-    }
+MidiFile::MidiFile() : myTicksPerBeat(0)
+{
+}
 
-    return location;
+void MidiFile::load(const Score &score, const LoadOptions &options,
+                    MidiEventCache *cache)
+{
+    generate(score, options, cache, TrackHandler());
 }
 
-MidiFile::MidiFile() : myTicksPerBeat(0)
+void MidiFile::stream(const Score &score, const LoadOptions &options,
+                      const TrackHandler &handler)
 {
+    generate(score, options, nullptr, handler);
 }
 
-void MidiFile::load(const Score &score, const LoadOptions &options)
+void MidiFile::generate(const Score &score, const LoadOptions &options,
+                        MidiEventCache *cache, const TrackHandler &handler)
 {
     myTicksPerBeat = DEFAULT_PPQ;
+    myPlayedBars.clear();
+
+    if (cache)
+        cache->setOptions(options);
 
-    RepeatController repeat_controller(score);
+    std::shared_ptr<const PlaybackOrder> order =
+        cache ? cache->getPlaybackOrder(score)
+              : std::make_shared<const PlaybackOrder>(score);
 
     MidiEventList master_track;
     MidiEventList metronome_track;
@@ -153,14 +145,38 @@ void MidiFile::load(const Score &score, const LoadOptions &options)
 
     }
 
-    SystemLocation location(0, 0);
+    std::vector<MidiEventList *> tracks;
+    tracks.push_back(&master_track);
+    for (MidiEventList &track : regular_tracks)
+        tracks.push_back(&track);
+    if (options.myEnableMetronome)
+        tracks.push_back(&metronome_track);
+
     std::vector<uint8_t> active_bends;
     int system_index = -1;
+    int system_start_tick = 0;
     int current_tick = 0;
     int current_tempo = Midi::BEAT_DURATION_120_BPM;
 
-    while (location.getSystem() < score.getSystems().size())
+    for (const PlaybackOrder::Bar &played_bar : order->getBars())
     {
+        const SystemLocation &location = played_bar.myLocation;
+
+        if (played_bar.myIsJump && options.myRecordPositionChanges)
+        {
+            metronome_track.append(
+                MidiEvent::positionChange(current_tick, location));
+        }
+
+        // Hand off the events once a system is finished. The events for the
+        // last system are held back, since grace notes at the start of the
+        // next system can be placed slightly before it.
+        if (handler && system_index >= 0 &&
+            location.getSystem() != system_index)
+        {
+            handler(tracks, system_start_tick);
+        }
+
         const System &system = score.getSystems()[location.getSystem()];
         const Barline *current_bar = ScoreUtils::findByPosition(
             system.getBarlines(), location.getPosition());
@@ -170,53 +186,119 @@ void MidiFile::load(const Score &score, const LoadOptions &options)
         {
             active_bends.resize(system.getStaves().size(), DEFAULT_BEND);
             system_index = location.getSystem();
+            system_start_tick = current_tick;
         }
 
-        const int start_tick = current_tick;
-        current_tempo =
-            addTempoEvent(master_track, start_tick, current_tempo, system,
-                          current_bar->getPosition(), next_bar->getPosition());
+        BarState state;
+        state.myTempo = current_tempo;
+        state.myActiveBends = active_bends;
+        // The players that are active before any player changes in this
+        // system.
+        const PlayerChange *players =
+            score.getCurrentPlayers(location.getSystem(), -1);
+        if (players)
+            state.myPlayers = *players;
+
+        std::shared_ptr<const BarEvents> bar;
+        if (cache)
+        {
+            bar = cache->find(location.getSystem(),
+                              current_bar->getPosition(), state);
+        }
 
-        for (unsigned int staff_index = 0; staff_index < system.getStaves().size();
-             ++staff_index)
+        if (!bar)
         {
-            const Staff &staff = system.getStaves()[staff_index];
+            bar = generateBar(score, system, location, *current_bar, *next_bar,
+                              state, options);
 
-            for (unsigned int voice_index = 0; voice_index < staff.getVoices().size();
-                 ++voice_index)
+            if (cache)
             {
-                const int end_tick = addEventsForBar(
-                    regular_tracks, active_bends[staff_index], start_tick,
-                    current_tempo, score, system, location.getSystem(), staff,
-                    staff_index, staff.getVoices()[voice_index], voice_index,
-                    current_bar->getPosition(), next_bar->getPosition(),
-                    options);
-
-                current_tick = std::max(current_tick, end_tick);
+                cache->insert(location.getSystem(),
+                              current_bar->getPosition(), bar);
             }
         }
 
-        // Generate metronome events.
-        current_tick = std::max(
-            current_tick,
-            generateMetronome(metronome_track, start_tick, system, *current_bar,
-                              *next_bar, location, options));
+        myPlayedBars.push_back(
+            { SystemLocation(location.getSystem(), current_bar->getPosition()),
+              current_tick + bar->myFirstTick });
 
-        location = moveToNextBar(
-            metronome_track, current_tick, options.myRecordPositionChanges,
-            system, location, next_bar->getPosition(), repeat_controller);
+        master_track.concat(bar->myMasterTrack, current_tick);
+        for (unsigned int i = 0; i < regular_tracks.size(); ++i)
+            regular_tracks[i].concat(bar->myPlayerTracks[i], current_tick);
+        metronome_track.concat(bar->myMetronomeTrack, current_tick);
+
+        current_tick += bar->myDuration;
+        current_tempo = bar->myEndState.myTempo;
+        active_bends = bar->myEndState.myActiveBends;
     }
 
-    myTracks.push_back(master_track);
-    myTracks.insert(myTracks.end(), regular_tracks.begin(), regular_tracks.end());
-    if (options.myEnableMetronome)
-        myTracks.push_back(metronome_track);
+    for (MidiEventList *track : tracks)
+        track->append(MidiEvent::endOfTrack(current_tick));
+
+    if (handler)
+    {
+        handler(tracks, std::numeric_limits<int>::max());
+        return;
+    }
+
+    for (MidiEventList *track : tracks)
+    {
+        track->convertToDeltaTicks();
+        myTracks.push_back(std::move(*track));
+    }
+}
 
-    for (MidiEventList &track : myTracks)
+std::shared_ptr<const MidiFile::BarEvents> MidiFile::generateBar(
+    const Score &score, const System &system, const SystemLocation &location,
+    const Barline &current_bar, const Barline &next_bar,
+    const BarState &state, const LoadOptions &options)
+{
+    auto bar = std::make_shared<BarEvents>();
+    bar->myStartState = state;
+    bar->myEndState = state;
+    bar->myPlayerTracks.resize(score.getPlayers().size());
+
+    std::vector<uint8_t> &active_bends = bar->myEndState.myActiveBends;
+    const int tempo =
+        addTempoEvent(bar->myMasterTrack, 0, state.myTempo, system,
+                      current_bar.getPosition(), next_bar.getPosition());
+    bar->myEndState.myTempo = tempo;
+
+    int end_tick = 0;
+    for (unsigned int staff_index = 0; staff_index < system.getStaves().size();
+         ++staff_index)
     {
-        track.append(MidiEvent::endOfTrack(current_tick));
-        track.convertToDeltaTicks();
+        const Staff &staff = system.getStaves()[staff_index];
+
+        for (unsigned int voice_index = 0; voice_index < staff.getVoices().size();
+             ++voice_index)
+        {
+            end_tick = std::max(
+                end_tick,
+                addEventsForBar(bar->myPlayerTracks, active_bends[staff_index],
+                                0, tempo, score, system, location.getSystem(),
+                                staff, staff_index,
+                                staff.getVoices()[voice_index], voice_index,
+                                current_bar.getPosition(),
+                                next_bar.getPosition(), options));
+        }
     }
+
+    // Generate metronome events.
+    end_tick = std::max(end_tick, generateMetronome(bar->myMetronomeTrack, 0,
+                                                    system, current_bar,
+                                                    next_bar, location,
+                                                    options));
+
+    bar->myDuration = end_tick;
+
+    for (const MidiEventList &track : bar->myPlayerTracks)
+    {
+        for (const MidiEvent &event : track)
+            bar->myFirstTick = std::min(bar->myFirstTick, event.getTicks());
+    }
+
+    return bar;
 }
 
 int MidiFile::generateMetronome(MidiEventList &event_list, int current_tick,
@@ -233,9 +315,8 @@ int MidiFile::generateMetronome(MidiEventList &event_list, int current_tick,
     const int beat_value = time_sig.getBeatValue();
 
     // Figure out the duration of a pulse.
-    const int duration = boost::rational_cast<int>(
-        boost::rational<int>(4, beat_value) *
-        boost::rational<int>(beats_per_measure, num_pulses) * myTicksPerBeat);
+    const int duration = 4 * beats_per_measure * myTicksPerBeat /
+                         (beat_value * num_pulses);
 
     // Check for multi-bar rests, as we need to generate more metronome events
     // to fill the extra bars.
@@ -291,14 +372,16 @@ int MidiFile::addTempoEvent(MidiEventList &event_list, int current_tick,
         const TempoMarker &marker = markers.back();
 
         // Convert the values in the TempoMarker::BeatType enum to a factor that
-        // will scale the bpm value to be in terms of quarter notes.
-        boost::rational<int> scale(2, 1 << (marker.getBeatType() / 2));
-        if (marker.getBeatType() % 2 != 0)
-            scale *= boost::rational<int>(3, 2);
+        // will scale the bpm value to be in terms of quarter notes. The factor
+        // is 2 / 2^n, or 3 / 2^n for dotted beat types.
+        const int64_t scale_denominator = int64_t(1)
+                                          << (marker.getBeatType() / 2);
+        const int scale_numerator = (marker.getBeatType() % 2 != 0) ? 3 : 2;
 
         // Compute the number of microseconds per quarter note.
-        current_tempo = boost::rational_cast<int>(
-            60000000 / (scale * marker.getBeatsPerMinute()));
+        current_tempo = static_cast<int>(
+            60000000 * scale_denominator /
+            (scale_numerator * marker.getBeatsPerMinute()));
 
         event_list.append(MidiEvent::setTempo(current_tick, current_tempo));
     }
@@ -312,12 +395,10 @@ static int getWholeRestDuration(const System &system, const Voice &voice,
 {
     // If the whole rest is not the only item in the bar, treat it like a
     // regular rest.
-    for (int i = bar_start; i < bar_end; ++i)
+    for (const Position &other_pos :
+         ScoreUtils::findInRange(voice.getPositions(), bar_start, bar_end - 1))
     {
-        const Position *other_pos =
-            ScoreUtils::findByPosition(voice.getPositions(), i);
-
-        if (other_pos && other_pos != &pos)
+        if (&other_pos != &pos)
             return original_duration;
     }
 
@@ -326,9 +407,7 @@ static int getWholeRestDuration(const System &system, const Voice &voice,
         ScoreUtils::findByPosition(system.getBarlines(), bar_start);
     const TimeSignature& time_sig = barline->getTimeSignature();
 
-    return boost::rational_cast<int>(
-        time_sig.getBeatsPerMeasure() *
-        boost::rational<int>(4, time_sig.getBeatValue()));
+    return 4 * time_sig.getBeatsPerMeasure() / time_sig.getBeatValue();
 }
 
 static int getActualNotePitch(const Note &note, const Tuning &tuning)
@@ -379,16 +458,14 @@ static Velocity getNoteVelocity(const Position &pos, const Note &note)
 /// a 32nd note at 120bpm.
 static int getGraceNoteTicks(int ppq, int current_tempo)
 {
-    return boost::rational_cast<int>(
-        boost::rational<int>(Midi::BEAT_DURATION_120_BPM, 8) /
-        boost::rational<int>(current_tempo, ppq));
+    return static_cast<int>(int64_t(Midi::BEAT_DURATION_120_BPM) * ppq /
+                            (8 * int64_t(current_tempo)));
 }
 
 static int getArpeggioOffset(int ppq, int current_tempo)
 {
-    return boost::rational_cast<int>(
-        boost::rational<int>(Midi::BEAT_DURATION_120_BPM, 16) /
-        boost::rational<int>(current_tempo, ppq));
+    return static_cast<int>(int64_t(Midi::BEAT_DURATION_120_BPM) * ppq /
+                            (16 * int64_t(current_tempo)));
 }
 
 /// Holds basic information about a bend - used to simplify the generateBends
@@ -429,10 +506,8 @@ static void generateBends(std::vector<BendEventInfo> &bends,
 {
     const Bend &bend = note.getBend();
 
-    const int bend_amount = boost::rational_cast<int>(
-        DEFAULT_BEND + bend.getBentPitch() * BEND_QUARTER_TONE);
-    const int release_amount = boost::rational_cast<int>(
-        DEFAULT_BEND + bend.getReleasePitch() * BEND_QUARTER_TONE);
+    const int bend_amount = getBendAmount(bend.getBentPitch());
+    const int release_amount = getBendAmount(bend.getReleasePitch());
 
     switch (bend.getType())
     {
@@ -527,10 +602,8 @@ static void generateSlides(std::vector<BendEventInfo> &bends, int start_tick,
         {
             if (next_note)
             {
-                bend_amount = boost::rational_cast<int>(
-                    DEFAULT_BEND +
-                    (next_note->getFretNumber() - note.getFretNumber()) * 2 *
-                        BEND_QUARTER_TONE);
+                bend_amount = getBendAmount(
+                    (next_note->getFretNumber() - note.getFretNumber()) * 2);
             }
             else
             {
@@ -578,6 +651,8 @@ int MidiFile::addEventsForBar(
     const Voice *prev_voice = VoiceUtils::getAdjacentVoice(location, -1);
     const Voice *next_voice = VoiceUtils::getAdjacentVoice(location, 1);
     bool let_ring_active = false;
+    const std::vector<VoiceUtils::Ticks> durations =
+        VoiceUtils::getDurationTicks(voice);
 
     for (int position = bar_start; position < bar_end; ++position)
     {
@@ -601,7 +676,7 @@ int MidiFile::addEventsForBar(
         if (!current_players)
         {
             current_players =
-                ScoreUtils::getCurrentPlayers(score, system_index, position);
+                score.getCurrentPlayers(system_index, position);
         }
         std::vector<ActivePlayer> active_players;
         if (current_players)
@@ -626,8 +701,9 @@ int MidiFile::addEventsForBar(
             continue;
 
         const SystemLocation system_location(system_index, position);
-        int duration = boost::rational_cast<int>(
-            myTicksPerBeat * VoiceUtils::getDurationTime(voice, *pos));
+        int duration = static_cast<int>(
+            durations[pos - &voice.getPositions().front()] * myTicksPerBeat /
+            VoiceUtils::TICKS_PER_QUARTER);
 
         if (pos->isRest())
         {
@@ -879,15 +955,13 @@ int MidiFile::addEventsForBar(
             if (!tied_to_next_note)
             {
                 // Shorten the note duration for certain effects.
-                boost::rational<int> factor(1);
+                int note_length = duration;
                 if (pos->hasProperty(Position::Staccato))
-                    factor /= 2;
+                    note_length /= 2;
                 else if (pos->hasProperty(Position::PalmMuting))
-                    factor /= boost::rational<int>(23, 20);
+                    note_length = note_length * 20 / 23;
                 else if (note.hasProperty(Note::Muted))
-                    factor /= 8;
-
-                int note_length = boost::rational_cast<int>(duration * factor);
+                    note_length /= 8;
 
                 for (const ActivePlayer &player : active_players)
                 {
@@ -18,16 +18,21 @@
 #ifndef MIDI_MIDIFILE_H
 #define MIDI_MIDIFILE_H
 
+#include <boost/optional/optional.hpp>
 #include <midi/midieventlist.h>
+#include <score/playerchange.h>
+#include <score/systemlocation.h>
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 
 class Barline;
+class MidiEventCache;
 class Score;
 class Staff;
 class System;
-class SystemLocation;
 class Voice;
 
 class MidiFile
@@ -46,6 +51,10 @@ public:
         {
         }
 
+        /// Returns whether the options would generate identical events for
+        /// each bar of the score.
+        bool generatesSameEvents(const LoadOptions &other) const;
+
         uint8_t myVibratoStrength;
         uint8_t myWideVibratoStrength;
         bool myEnableMetronome;
@@ -55,15 +64,87 @@ public:
         bool myRecordPositionChanges;
     };
 
+    /// The state that the events for a bar depend on, in addition to the
+    /// contents of the bar.
+    struct BarState
+    {
+        BarState();
+
+        bool operator==(const BarState &other) const;
+
+        int myTempo;
+        std::vector<uint8_t> myActiveBends;
+        /// The player change that is active at the start of the system.
+        boost::optional<PlayerChange> myPlayers;
+    };
+
+    /// Events for a bar, with ticks relative to the start of the bar.
+    struct BarEvents
+    {
+        BarEvents();
+
+        BarState myStartState;
+        BarState myEndState;
+        int myDuration;
+        /// The earliest tick of the bar's events. This is negative if a grace
+        /// note at the start of the bar is played before the barline.
+        int myFirstTick;
+
+        MidiEventList myMasterTrack;
+        std::vector<MidiEventList> myPlayerTracks;
+        MidiEventList myMetronomeTrack;
+    };
+
+    /// A bar that was played, in playback order.
+    struct PlayedBar
+    {
+        SystemLocation myLocation;
+        /// The tick of the bar's first event.
+        int myTick;
+    };
+
     MidiFile();
 
-    void load(const Score &score, const LoadOptions &options);
+    /// Generates the MIDI events for the score. If a cache is provided, the
+    /// events for any bars that have not changed are reused from the cache.
+    void load(const Score &score, const LoadOptions &options,
+              MidiEventCache *cache = nullptr);
+
+    /// Receives the tracks (in the same order as getTracks(), using absolute
+    /// ticks) while the score is being generated. The events before the given
+    /// tick are final, and can be removed from the tracks once consumed.
+    typedef std::function<void(const std::vector<MidiEventList *> &tracks,
+                               int complete_tick)> TrackHandler;
+
+    /// Generates the MIDI events for the score system-by-system, passing the
+    /// tracks to the handler after each system rather than storing them in
+    /// getTracks(). This bounds the number of pending events for long scores.
+    void stream(const Score &score, const LoadOptions &options,
+                const TrackHandler &handler);
 
     int getTicksPerBeat() const { return myTicksPerBeat; }
     std::vector<MidiEventList> &getTracks() { return myTracks; }
     const std::vector<MidiEventList> &getTracks() const { return myTracks; }
+    /// Returns each bar that was played, including each time that a repeated
+    /// bar was played.
+    const std::vector<PlayedBar> &getPlayedBars() const
+    {
+        return myPlayedBars;
+    }
 
 private:
+    /// Generates the events for the score, either passing them to the handler
+    /// or storing them in myTracks if no handler is provided.
+    void generate(const Score &score, const LoadOptions &options,
+                  MidiEventCache *cache, const TrackHandler &handler);
+
+    /// Generates the events for all staves in a bar, starting at tick 0.
+    std::shared_ptr<const BarEvents> generateBar(
+        const Score &score, const System &system,
+        const SystemLocation &location, const Barline &current_bar,
+        const Barline &next_bar, const BarState &state,
+        const LoadOptions &options);
+
     int generateMetronome(MidiEventList &event_list, int current_tick,
                           const System &system, const Barline &current_bar,
                           const Barline &next_bar,
@@ -84,6 +165,7 @@ private:
 
     int myTicksPerBeat;
     std::vector<MidiEventList> myTracks;
+    std::vector<PlayedBar> myPlayedBars;
 };
 
 #endif
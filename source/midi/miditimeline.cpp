@@ -0,0 +1,229 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "miditimeline.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <score/generalmidi.h>
+
+MidiTimeline::ChannelState::ChannelState()
+    : myProgram(UNSET),
+      myVolume(UNSET),
+      myModWheel(UNSET),
+      myHoldPedal(UNSET),
+      myPitchWheel(UNSET),
+      myPitchBendRange(UNSET)
+{
+}
+
+void MidiTimeline::ChannelState::update(const MidiEvent &event)
+{
+    const uint8_t *data = event.getData();
+
+    switch (event.getMessageType())
+    {
+    case MidiEvent::ProgramChange:
+        myProgram = data[1];
+        break;
+    case MidiEvent::PitchWheel:
+        myPitchWheel = data[2];
+        break;
+    case MidiEvent::ControlChange:
+        switch (data[1])
+        {
+        case MidiEvent::ChannelVolume:
+            myVolume = data[2];
+            break;
+        case MidiEvent::ModWheel:
+            myModWheel = data[2];
+            break;
+        case MidiEvent::HoldPedal:
+            myHoldPedal = data[2];
+            break;
+        case MidiEvent::DataEntryCoarse:
+            // The pitch bend range is the only registered parameter that is
+            // changed.
+            myPitchBendRange = data[2];
+            break;
+        }
+        break;
+    }
+}
+
+void MidiTimeline::ChannelState::addMessages(
+    uint8_t channel, std::vector<MidiEvent> &messages) const
+{
+    if (myPitchBendRange != UNSET)
+    {
+        for (const MidiEvent &event :
+             MidiEvent::pitchWheelRange(0, channel, myPitchBendRange))
+        {
+            messages.push_back(event);
+        }
+    }
+
+    if (myProgram != UNSET)
+        messages.push_back(MidiEvent::programChange(0, channel, myProgram));
+    if (myVolume != UNSET)
+        messages.push_back(MidiEvent::volumeChange(0, channel, myVolume));
+    if (myModWheel != UNSET)
+        messages.push_back(MidiEvent::modWheel(0, channel, myModWheel));
+    if (myHoldPedal != UNSET)
+    {
+        messages.push_back(
+            MidiEvent::holdPedal(0, channel, myHoldPedal >= 64));
+    }
+    if (myPitchWheel != UNSET)
+        messages.push_back(MidiEvent::pitchWheel(0, channel, myPitchWheel));
+}
+
+MidiTimeline::MidiTimeline(MidiEventList events, int ticks_per_beat,
+                           const std::vector<MidiFile::PlayedBar> &bars)
+    : myEvents(std::move(events))
+{
+    assert(ticks_per_beat > 0);
+
+    int beat_duration = Midi::BEAT_DURATION_120_BPM;
+    // Times are measured from the most recent tempo change, so that rounding
+    // errors don't accumulate.
+    int tempo_ticks = 0;
+    int64_t tempo_time = 0;
+
+    ChannelStates channels;
+    auto bar = bars.begin();
+
+    auto event = myEvents.begin();
+    while (event != myEvents.end())
+    {
+        const int ticks = event->getTicks();
+        assert(ticks >= tempo_ticks);
+
+        // Record the state for any bars that start with this group.
+        for (; bar != bars.end() && bar->myTick <= ticks; ++bar)
+            myBars.push_back({ bar->myLocation, myGroups.size(), channels });
+
+        Group group;
+        group.myBegin = event;
+        group.myTime = Duration(
+            tempo_time + static_cast<int64_t>(ticks - tempo_ticks) *
+                             beat_duration / ticks_per_beat);
+
+        // A tempo change only affects the time until the following events.
+        for (; event != myEvents.end() && event->getTicks() == ticks; ++event)
+        {
+            if (event->isTempoChange())
+            {
+                beat_duration = event->getTempo();
+                tempo_ticks = ticks;
+                tempo_time = group.myTime.count();
+            }
+            else if (event->isChannelMessage())
+                channels[event->getChannel()].update(*event);
+        }
+
+        group.myEnd = event;
+        group.myBeatDuration = beat_duration;
+        myGroups.push_back(group);
+    }
+
+    for (; bar != bars.end(); ++bar)
+        myBars.push_back({ bar->myLocation, myGroups.size(), channels });
+
+    myBarsByLocation.resize(myBars.size());
+    for (size_t i = 0; i < myBars.size(); ++i)
+        myBarsByLocation[i] = i;
+
+    std::stable_sort(myBarsByLocation.begin(), myBarsByLocation.end(),
+                     [&](size_t a, size_t b)
+    {
+        return myBars[a].myLocation < myBars[b].myLocation;
+    });
+}
+
+const MidiTimeline::Bar *MidiTimeline::findBar(
+    const SystemLocation &location) const
+{
+    // Find the bar containing the location.
+    auto it = std::upper_bound(
+        myBarsByLocation.begin(), myBarsByLocation.end(), location,
+        [&](const SystemLocation &loc, size_t i)
+    {
+        return loc < myBars[i].myLocation;
+    });
+
+    if (it == myBarsByLocation.begin())
+        return nullptr;
+
+    // Find the first time that the bar was played.
+    const SystemLocation &bar_location = myBars[*(it - 1)].myLocation;
+    it = std::lower_bound(myBarsByLocation.begin(), it, bar_location,
+                          [&](size_t i, const SystemLocation &loc)
+    {
+        return myBars[i].myLocation < loc;
+    });
+
+    return &myBars[*it];
+}
+
+size_t MidiTimeline::findGroup(Duration time) const
+{
+    auto it = std::lower_bound(myGroups.begin(), myGroups.end(), time,
+                               [](const Group &group, Duration t)
+    {
+        return group.myTime < t;
+    });
+
+    return it - myGroups.begin();
+}
+
+std::vector<MidiEvent> MidiTimeline::getChannelState(size_t group) const
+{
+    // Start from the closest bar, and then apply the remaining events.
+    ChannelStates channels;
+    size_t begin = 0;
+
+    auto bar = std::upper_bound(myBars.begin(), myBars.end(), group,
+                                [](size_t g, const Bar &bar)
+    {
+        return g < bar.myGroup;
+    });
+
+    if (bar != myBars.begin())
+    {
+        --bar;
+        channels = bar->myChannels;
+        begin = bar->myGroup;
+    }
+
+    for (size_t i = begin; i < group; ++i)
+    {
+        for (auto event = myGroups[i].myBegin; event != myGroups[i].myEnd;
+             ++event)
+        {
+            if (event->isChannelMessage() && !event->isNoteOnOff())
+                channels[event->getChannel()].update(*event);
+        }
+    }
+
+    std::vector<MidiEvent> messages;
+    for (uint8_t channel = 0; channel < NUM_CHANNELS; ++channel)
+        channels[channel].addMessages(channel, messages);
+
+    return messages;
+}
@@ -0,0 +1,116 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef MIDI_MIDITIMELINE_H
+#define MIDI_MIDITIMELINE_H
+
+#include <array>
+#include <chrono>
+#include <midi/midieventlist.h>
+#include <midi/midifile.h>
+#include <vector>
+
+/// Converts a list of MIDI events from ticks to absolute times, applying the
+/// tempo changes once up front. This allows playback to wait until fixed
+/// deadlines, rather than accumulating timing errors by sleeping for each
+/// event's delta time.
+/// The timeline also records the channel state at the start of each bar, so
+/// that playback can begin at any point without replaying the earlier events.
+class MidiTimeline
+{
+public:
+    typedef std::chrono::microseconds Duration;
+
+    /// A set of consecutive events that occur at the same time.
+    struct Group
+    {
+        /// Time since the start of the score, at the normal playback speed.
+        Duration myTime;
+        /// The tempo (microseconds per beat) after the group's events.
+        int myBeatDuration;
+        MidiEventList::const_iterator myBegin;
+        MidiEventList::const_iterator myEnd;
+    };
+
+    /// The controller values and other settings for a channel.
+    struct ChannelState
+    {
+        /// Marks a value that has not been set by any events.
+        static const uint8_t UNSET = 0xff;
+
+        ChannelState();
+
+        /// Records any change made by the event.
+        void update(const MidiEvent &event);
+        /// Adds the messages that restore this state on the given channel.
+        void addMessages(uint8_t channel,
+                         std::vector<MidiEvent> &messages) const;
+
+        uint8_t myProgram;
+        uint8_t myVolume;
+        uint8_t myModWheel;
+        uint8_t myHoldPedal;
+        uint8_t myPitchWheel;
+        uint8_t myPitchBendRange;
+    };
+
+    static const int NUM_CHANNELS = 16;
+    typedef std::array<ChannelState, NUM_CHANNELS> ChannelStates;
+
+    /// A point in the timeline where a bar begins to play.
+    struct Bar
+    {
+        SystemLocation myLocation;
+        /// The index of the bar's first group.
+        size_t myGroup;
+        /// The state of each channel before the bar's first group.
+        ChannelStates myChannels;
+    };
+
+    /// The events must be sorted, and use absolute ticks. The bars are the
+    /// bars that were played to generate the events.
+    MidiTimeline(MidiEventList events, int ticks_per_beat,
+                 const std::vector<MidiFile::PlayedBar> &bars);
+
+    // The groups refer to the timeline's events.
+    MidiTimeline(const MidiTimeline &) = delete;
+    MidiTimeline &operator=(const MidiTimeline &) = delete;
+
+    const std::vector<Group> &getGroups() const { return myGroups; }
+    const std::vector<Bar> &getBars() const { return myBars; }
+
+    /// Returns the first time that the bar containing the location is played,
+    /// or the closest earlier bar if that bar is never played. Returns null if
+    /// no bars are played before the location.
+    const Bar *findBar(const SystemLocation &location) const;
+
+    /// Returns the index of the first group at or after the given time.
+    size_t findGroup(Duration time) const;
+
+    /// Returns the messages needed to restore the state of each channel
+    /// before the given group is played.
+    std::vector<MidiEvent> getChannelState(size_t group) const;
+
+private:
+    MidiEventList myEvents;
+    std::vector<Group> myGroups;
+    std::vector<Bar> myBars;
+    /// The indices of myBars, sorted by location and then playback order.
+    std::vector<size_t> myBarsByLocation;
+};
+
+#endif
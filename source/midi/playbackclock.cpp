@@ -0,0 +1,71 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "playbackclock.h"
+
+#include <algorithm>
+#include <thread>
+
+constexpr std::chrono::microseconds PlaybackClock::SPIN_DURATION;
+constexpr std::chrono::milliseconds PlaybackClock::MAX_SLEEP_DURATION;
+
+PlaybackClock::PlaybackClock(MidiTimeline::Duration score_time, int speed,
+                             Clock::time_point start_time)
+    : myStartTime(start_time), myScoreTime(score_time), mySpeed(speed)
+{
+}
+
+bool PlaybackClock::waitUntil(MidiTimeline::Duration score_time,
+                              const std::atomic<bool> &is_playing,
+                              const std::atomic<int> &speed)
+{
+    while (is_playing)
+    {
+        if (speed != mySpeed)
+            setSpeed(speed);
+
+        const Clock::time_point now = Clock::now();
+        const Clock::time_point deadline = getDeadline(score_time);
+        if (now >= deadline)
+            return true;
+
+        const Clock::duration remaining = deadline - now;
+        if (remaining > SPIN_DURATION)
+        {
+            std::this_thread::sleep_for(std::min<Clock::duration>(
+                remaining - SPIN_DURATION, MAX_SLEEP_DURATION));
+        }
+        else
+            std::this_thread::yield();
+    }
+
+    return false;
+}
+
+PlaybackClock::Clock::time_point PlaybackClock::getDeadline(
+    MidiTimeline::Duration score_time) const
+{
+    return myStartTime + (score_time - myScoreTime) * 100 / mySpeed;
+}
+
+void PlaybackClock::setSpeed(int speed, Clock::time_point now)
+{
+    myScoreTime += std::chrono::duration_cast<MidiTimeline::Duration>(
+        (now - myStartTime) * mySpeed / 100);
+    myStartTime = now;
+    mySpeed = speed;
+}
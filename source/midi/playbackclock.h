@@ -0,0 +1,63 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef MIDI_PLAYBACKCLOCK_H
+#define MIDI_PLAYBACKCLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <midi/miditimeline.h>
+
+/// Converts times in the score into deadlines on the system clock, taking the
+/// playback speed into account.
+class PlaybackClock
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /// Sleeping for short amounts of time is imprecise, so busy-wait for the
+    /// final part of the interval.
+    static constexpr std::chrono::microseconds SPIN_DURATION{ 1000 };
+    /// Don't sleep for longer than this without checking whether the playback
+    /// has been stopped or the speed has changed.
+    static constexpr std::chrono::milliseconds MAX_SLEEP_DURATION{ 50 };
+
+    /// The score time is played at the start time, and the speed is a
+    /// percentage of the normal playback speed.
+    PlaybackClock(MidiTimeline::Duration score_time, int speed,
+                  Clock::time_point start_time = Clock::now());
+
+    /// Waits until the given time in the score. Returns false if playback was
+    /// stopped before then.
+    bool waitUntil(MidiTimeline::Duration score_time,
+                   const std::atomic<bool> &is_playing,
+                   const std::atomic<int> &speed);
+
+    /// Returns when the given time in the score will be played, at the
+    /// current speed.
+    Clock::time_point getDeadline(MidiTimeline::Duration score_time) const;
+
+    /// Measures future times from the given time, using the new speed.
+    void setSpeed(int speed, Clock::time_point now = Clock::now());
+
+private:
+    Clock::time_point myStartTime;
+    MidiTimeline::Duration myScoreTime;
+    int mySpeed;
+};
+
+#endif
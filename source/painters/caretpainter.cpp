@@ -18,9 +18,8 @@
 #include "caretpainter.h"
 
 #include <app/caret.h>
-#include <app/viewoptions.h>
 #include <boost/lexical_cast.hpp>
-#include <painters/layoutinfo.h>
+#include <painters/layoutcache.h>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QPainter>
@@ -31,9 +30,10 @@
 const double CaretPainter::PEN_WIDTH = 0.75;
 const double CaretPainter::CARET_NOTE_SPACING = 6;
 
-CaretPainter::CaretPainter(const Caret &caret, const ViewOptions &view_options)
+CaretPainter::CaretPainter(const Caret &caret,
+                           const std::shared_ptr<LayoutCache> &layout_cache)
     : myCaret(caret),
-      myViewOptions(view_options),
+      myLayoutCache(layout_cache),
       myCaretConnection(caret.subscribeToChanges([=]() {
           onLocationChanged();
       }))
@@ -166,33 +166,26 @@ void CaretPainter::onLocationChanged()
     if (system.getStaves().empty())
         return;
 
-    myLayout.reset(new LayoutInfo(location.getScore(), system,
-                                  location.getSystemIndex(), location.getStaff(),
-                                  location.getStaffIndex()));
+    myLayout = myLayoutCache->getLayout(location.getSystemIndex(),
+                                        location.getStaffIndex());
 
-    const ViewFilter *filter =
-        myViewOptions.getFilter()
-            ? &location.getScore().getViewFilters()[*myViewOptions.getFilter()]
-            : nullptr;
-
-    // Compute the offset due to the previous (visible) staves.
-    double offset = 0;
-    for (int i = 0; i < location.getStaffIndex(); ++i)
+    // The caret's staff might be hidden by the view filter, in which case its
+    // layout isn't cached.
+    if (!myLayout)
     {
-        if (!filter ||
-            filter->accept(location.getScore(), location.getSystemIndex(), i))
-        {
-            offset += LayoutInfo(location.getScore(), system,
-                                 location.getSystemIndex(),
-                                 system.getStaves()[i], i).getStaffHeight();
-        }
+        myLayout = std::make_shared<LayoutInfo>(
+            location.getScore(), system, location.getSystemIndex(),
+            location.getStaff(), location.getStaffIndex());
     }
 
+    // The offset due to the system symbols and the previous (visible) staves.
+    const double offset = myLayoutCache->getStaffOffset(
+        location.getSystemIndex(), location.getStaffIndex());
+
     const QRectF oldRect = sceneBoundingRect();
     setPos(0, mySystemRects.at(location.getSystemIndex()).top() + offset +
-           myLayout->getSystemSymbolSpacing() + myLayout->getStaffHeight() -
-           myLayout->getTabStaffBelowSpacing() - myLayout->STAFF_BORDER_SPACING -
-           myLayout->getTabStaffHeight());
+           myLayout->getStaffHeight() - myLayout->getTabStaffBelowSpacing() -
+           myLayout->STAFF_BORDER_SPACING - myLayout->getTabStaffHeight());
     update(boundingRect());
     // Ensure that a redraw always occurs at the old location.
     scene()->update(oldRect);
@@ -20,16 +20,19 @@
 
 #include <boost/signals2/signal.hpp>
 #include <memory>
+#include <painters/layoutinfo.h>
 #include <QGraphicsItem>
 
 class Caret;
-struct LayoutInfo;
-class ViewOptions;
+class LayoutCache;
 
 class CaretPainter : public QGraphicsItem
 {
 public:
-    CaretPainter(const Caret &caret, const ViewOptions &view_options);
+    /// The caret's layout is taken from the cache, which is shared with the
+    /// score area.
+    CaretPainter(const Caret &caret,
+                 const std::shared_ptr<LayoutCache> &layout_cache);
 
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                        QWidget *) override;
@@ -52,8 +55,8 @@ private:
     void onLocationChanged();
 
     const Caret &myCaret;
-    const ViewOptions &myViewOptions;
-    std::unique_ptr<LayoutInfo> myLayout;
+    std::shared_ptr<LayoutCache> myLayoutCache;
+    LayoutConstPtr myLayout;
     std::vector<QRectF> mySystemRects;
     boost::signals2::scoped_connection myCaretConnection;
     LocationChangedSlot onMyLocationChanged;
@@ -0,0 +1,112 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "layoutcache.h"
+
+#include <painters/systemrenderer.h>
+#include <score/score.h>
+
+LayoutCache::LayoutCache(const Score &score, const ViewOptions &view_options)
+    : myScore(score),
+      myViewOptions(view_options),
+      mySystems(score.getSystems().size())
+{
+}
+
+bool LayoutCache::contains(int system) const
+{
+    return system < static_cast<int>(mySystems.size()) && mySystems[system];
+}
+
+const std::vector<LayoutConstPtr> &LayoutCache::getLayouts(int system)
+{
+    return getSystemLayout(system).myLayouts;
+}
+
+LayoutConstPtr LayoutCache::getLayout(int system, int staff)
+{
+    return getSystemLayout(system).myLayouts.at(staff);
+}
+
+double LayoutCache::getStaffOffset(int system, int staff)
+{
+    return getSystemLayout(system).myStaffOffsets.at(staff);
+}
+
+void LayoutCache::setLayouts(int system, std::vector<LayoutConstPtr> layouts)
+{
+    SystemLayout entry;
+    entry.myLayouts = std::move(layouts);
+
+    // The system symbols are drawn above the first visible staff.
+    double offset =
+        LayoutInfo::getSystemSymbolSpacing(myScore.getSystems()[system]);
+    entry.myStaffOffsets.reserve(entry.myLayouts.size());
+    for (const LayoutConstPtr &layout : entry.myLayouts)
+    {
+        entry.myStaffOffsets.push_back(offset);
+        if (layout)
+            offset += layout->getStaffHeight();
+    }
+
+    if (system >= static_cast<int>(mySystems.size()))
+        mySystems.resize(system + 1);
+    mySystems[system] = std::move(entry);
+}
+
+void LayoutCache::invalidate(int system)
+{
+    if (system < static_cast<int>(mySystems.size()))
+        mySystems[system].reset();
+}
+
+void LayoutCache::clear()
+{
+    mySystems.assign(myScore.getSystems().size(), boost::none);
+}
+
+bool LayoutCache::isCurrent(int system) const
+{
+    if (!contains(system))
+        return false;
+
+    const System &current = myScore.getSystems()[system];
+    const std::vector<LayoutConstPtr> &layouts = mySystems[system]->myLayouts;
+    if (layouts.size() != current.getStaves().size())
+        return false;
+
+    for (size_t i = 0; i < layouts.size(); ++i)
+    {
+        if (layouts[i] && !layouts[i]->isCurrent(current, static_cast<int>(i)))
+            return false;
+    }
+
+    return true;
+}
+
+const LayoutCache::SystemLayout &LayoutCache::getSystemLayout(int system)
+{
+    // Never return layouts that refer to staves which no longer exist.
+    if (!isCurrent(system))
+    {
+        setLayouts(system, SystemRenderer::computeLayouts(
+                               myScore, myScore.getSystems()[system], system,
+                               myViewOptions));
+    }
+
+    return *mySystems[system];
+}
@@ -0,0 +1,82 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef PAINTERS_LAYOUTCACHE_H
+#define PAINTERS_LAYOUTCACHE_H
+
+#include <boost/optional.hpp>
+#include <painters/layoutinfo.h>
+#include <vector>
+
+class Score;
+class ViewOptions;
+
+/// Stores the layout of each staff in a document's systems, along with the
+/// vertical offset of each staff within its system. This is shared by the
+/// score area and the caret, so that moving the caret (e.g. on every note
+/// during playback) doesn't need to lay out the staff again.
+/// The score area is responsible for invalidating a system whenever it is
+/// modified. Layouts that refer to staves which have since been copied or
+/// moved (e.g. when an undo snapshot is taken) are also recomputed.
+class LayoutCache
+{
+public:
+    LayoutCache(const Score &score, const ViewOptions &view_options);
+
+    /// Returns whether the layouts for the system are available.
+    bool contains(int system) const;
+
+    /// Returns the layout of each staff in the system, computing them if
+    /// necessary. Staves that are hidden by the view filter have a null
+    /// layout.
+    const std::vector<LayoutConstPtr> &getLayouts(int system);
+
+    /// Returns the layout of a staff, or null if it is hidden.
+    LayoutConstPtr getLayout(int system, int staff);
+
+    /// Returns the distance from the top of the system to the top of the
+    /// staff, which includes the system symbols and any previous visible
+    /// staves.
+    double getStaffOffset(int system, int staff);
+
+    /// Stores layouts that were computed elsewhere (e.g. on a worker thread
+    /// when rendering the system).
+    void setLayouts(int system, std::vector<LayoutConstPtr> layouts);
+
+    /// Discards the system's layouts, after the system was modified.
+    void invalidate(int system);
+    /// Discards every system's layouts, e.g. after systems were inserted or
+    /// removed.
+    void clear();
+
+private:
+    struct SystemLayout
+    {
+        std::vector<LayoutConstPtr> myLayouts;
+        std::vector<double> myStaffOffsets;
+    };
+
+    /// Returns whether the cached layouts still refer to the system's staves.
+    bool isCurrent(int system) const;
+    const SystemLayout &getSystemLayout(int system);
+
+    const Score &myScore;
+    const ViewOptions &myViewOptions;
+    std::vector<boost::optional<SystemLayout>> mySystems;
+};
+
+#endif
@@ -46,6 +46,7 @@ LayoutInfo::LayoutInfo(const Score &score, const System &system, int systemIndex
                        const Staff &staff, int staffIndex)
     : mySystem(system),
       myStaff(staff),
+      myStavesGeneration(system.getStavesGeneration()),
       myLineSpacing(score.getLineSpacing()),
       myPositionSpacing(0),
       myNumPositions(0),
@@ -77,16 +78,31 @@ LayoutInfo::LayoutInfo(const Score &score, const System &system, int systemIndex
     }
 }
 
+bool LayoutInfo::isCurrent(const System &system, int staffIndex) const
+{
+    // The generation detects a new copy of the staves that happens to reuse
+    // the old address, and the address detects the staves being reallocated
+    // when they were not shared.
+    return &system == &mySystem &&
+           system.getStavesGeneration() == myStavesGeneration &&
+           &system.getStaves()[staffIndex] == &myStaff;
+}
+
 int LayoutInfo::getStringCount() const
 {
     return myStaff.getStringCount();
 }
 
 double LayoutInfo::getSystemSymbolSpacing() const
+{
+    return getSystemSymbolSpacing(mySystem);
+}
+
+double LayoutInfo::getSystemSymbolSpacing(const System &system)
 {
     double height = 0;
 
-    for (const Barline &barline : mySystem.getBarlines())
+    for (const Barline &barline : system.getBarlines())
     {
         if (barline.hasRehearsalSign())
         {
@@ -95,20 +111,20 @@ double LayoutInfo::getSystemSymbolSpacing() const
         }
     }
 
-    if (!mySystem.getAlternateEndings().empty())
+    if (!system.getAlternateEndings().empty())
         height += SYSTEM_SYMBOL_SPACING;
 
-    if (!mySystem.getTempoMarkers().empty())
+    if (!system.getTempoMarkers().empty())
         height += SYSTEM_SYMBOL_SPACING;
 
-    if (!mySystem.getChords().empty())
+    if (!system.getChords().empty())
         height += SYSTEM_SYMBOL_SPACING;
 
-    if (!mySystem.getTextItems().empty())
+    if (!system.getTextItems().empty())
         height += SYSTEM_SYMBOL_SPACING;
 
     double directionHeight = 0;
-    for (const Direction &direction : mySystem.getDirections())
+    for (const Direction &direction : system.getDirections())
     {
         directionHeight = std::max(directionHeight,
                                    direction.getSymbols().size() *
@@ -124,9 +140,14 @@ double LayoutInfo::getStaffHeight() const
 {
     return myStdNotationStaffAboveSpacing + myStdNotationStaffBelowSpacing +
             myTabStaffAboveSpacing + myTabStaffBelowSpacing +
-            STD_NOTATION_LINE_SPACING * (NUM_STD_NOTATION_LINES - 1) +
-            (getStringCount() - 1) * getTabLineSpacing() +
-            4 * STAFF_BORDER_SPACING;
+            getMinStaffHeight(myStaff, myLineSpacing);
+}
+
+double LayoutInfo::getMinStaffHeight(const Staff &staff, int lineSpacing)
+{
+    return STD_NOTATION_LINE_SPACING * (NUM_STD_NOTATION_LINES - 1) +
+           (staff.getStringCount() - 1) * lineSpacing +
+           4 * STAFF_BORDER_SPACING;
 }
 
 double LayoutInfo::getStdNotationLine(int line) const
@@ -19,6 +19,7 @@
 #define PAINTERS_LAYOUTINFO_H
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <painters/beamgroup.h>
 #include <painters/stdnotationnote.h>
@@ -98,10 +99,20 @@ struct LayoutInfo
     LayoutInfo(const Score &score, const System& system, int systemIndex,
                const Staff &staff, int staffIndex);
 
+    /// Returns whether the layout was computed for the current staves of the
+    /// system, i.e. the system and staff have not since been copied or
+    /// moved.
+    bool isCurrent(const System &system, int staffIndex) const;
     int getStringCount() const;
 
     double getSystemSymbolSpacing() const;
+    /// Returns the space needed for the system-level symbols (e.g. tempo
+    /// markers) above the first staff.
+    static double getSystemSymbolSpacing(const System &system);
     double getStaffHeight() const;
+    /// Returns the height of the staff if it has no symbols above or below
+    /// the staves, without computing a full layout.
+    static double getMinStaffHeight(const Staff &staff, int lineSpacing);
 
     double getStdNotationLine(int line) const;
     double getStdNotationSpace(int space) const;
@@ -208,6 +219,7 @@ private:
 
     const System &mySystem;
     const Staff &myStaff;
+    uint64_t myStavesGeneration;
     int myLineSpacing;
     double myPositionSpacing;
     int myNumPositions;
@@ -103,8 +103,9 @@ double NoteStem::getNoteHeadWidth() const
 
 double NoteStem::getDurationTime() const
 {
-    return boost::rational_cast<double>(
-        VoiceUtils::getDurationTime(*myVoice, *myPosition));
+    return static_cast<double>(
+               VoiceUtils::getDurationTicks(*myVoice, *myPosition)) /
+           VoiceUtils::TICKS_PER_QUARTER;
 }
 
 int NoteStem::getPositionIndex() const
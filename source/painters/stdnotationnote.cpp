@@ -137,8 +137,8 @@ void StdNotationNote::getNotesInStaff(
 
                 // Find an active player so that we know what tuning to use.
                 std::vector<ActivePlayer> activePlayers;
-                const PlayerChange *players = ScoreUtils::getCurrentPlayers(
-                            score, systemIndex, pos.getPosition());
+                const PlayerChange *players = score.getCurrentPlayers(
+                            systemIndex, pos.getPosition());
                 if (players)
                     activePlayers = players->getActivePlayers(staffIndex);
 
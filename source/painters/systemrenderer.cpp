@@ -77,32 +77,111 @@ SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
     myRehearsalSignFont.setPixelSize(12);
 }
 
-QGraphicsItem *SystemRenderer::operator()(const System &system,
-                                          int systemIndex)
+std::vector<LayoutConstPtr> SystemRenderer::computeLayouts(
+    const Score &score, const System &system, int systemIndex,
+    const ViewOptions &view_options)
 {
-    // Draw the bounding rectangle for the system.
-    myParentSystem = new QGraphicsRectItem();
-    myParentSystem->setPen(QPen(QBrush(QColor(0, 0, 0, 127)), 0.5));
+    const ViewFilter *filter =
+        view_options.getFilter()
+            ? &score.getViewFilters()[*view_options.getFilter()]
+            : nullptr;
+
+    std::vector<LayoutConstPtr> layouts;
+    layouts.reserve(system.getStaves().size());
+
+    int i = 0;
+    for (const Staff &staff : system.getStaves())
+    {
+        if (filter && !filter->accept(score, systemIndex, i))
+            layouts.push_back(nullptr);
+        else
+        {
+            layouts.push_back(std::make_shared<LayoutInfo>(
+                score, system, systemIndex, staff, i));
+        }
+
+        ++i;
+    }
+
+    return layouts;
+}
 
+LayoutConstPtr SystemRenderer::computeLayout(const Score &score,
+                                             const System &system,
+                                             int systemIndex, int staffIndex,
+                                             const ViewOptions &view_options)
+{
     const ViewFilter *filter =
-        myViewOptions.getFilter()
-            ? &myScore.getViewFilters()[*myViewOptions.getFilter()]
+        view_options.getFilter()
+            ? &score.getViewFilters()[*view_options.getFilter()]
+            : nullptr;
+
+    if (filter && !filter->accept(score, systemIndex, staffIndex))
+        return nullptr;
+
+    return std::make_shared<LayoutInfo>(score, system, systemIndex,
+                                        system.getStaves()[staffIndex],
+                                        staffIndex);
+}
+
+double SystemRenderer::estimateHeight(const Score &score,
+                                      const System &system, int systemIndex,
+                                      const ViewOptions &view_options)
+{
+    const ViewFilter *filter =
+        view_options.getFilter()
+            ? &score.getViewFilters()[*view_options.getFilter()]
             : nullptr;
 
-    // Draw each staff.
     double height = 0;
+    bool isFirstStaff = true;
+
     int i = 0;
     for (const Staff &staff : system.getStaves())
     {
-        if (filter && !filter->accept(myScore, systemIndex, i))
+        if (!filter || filter->accept(score, systemIndex, i))
         {
-            ++i;
-            continue;
+            if (isFirstStaff)
+            {
+                height += LayoutInfo::getSystemSymbolSpacing(system);
+                isFirstStaff = false;
+            }
+
+            height += LayoutInfo::getMinStaffHeight(staff,
+                                                    score.getLineSpacing());
         }
 
+        ++i;
+    }
+
+    return height;
+}
+
+QGraphicsItem *SystemRenderer::operator()(const System &system,
+                                          int systemIndex)
+{
+    return (*this)(system, systemIndex,
+                   computeLayouts(myScore, system, systemIndex, myViewOptions));
+}
+
+QGraphicsItem *SystemRenderer::operator()(
+    const System &system, int systemIndex,
+    const std::vector<LayoutConstPtr> &layouts)
+{
+    // Draw the bounding rectangle for the system.
+    myParentSystem = new QGraphicsRectItem();
+    myParentSystem->setPen(QPen(QBrush(QColor(0, 0, 0, 127)), 0.5));
+    myStaffItems.assign(layouts.size(), nullptr);
+
+    // Draw each staff.
+    double height = 0;
+    for (size_t i = 0; i < layouts.size(); ++i)
+    {
+        const LayoutConstPtr &layout = layouts[i];
+        if (!layout)
+            continue;
+
         const bool isFirstStaff = (height == 0);
-        LayoutConstPtr layout = std::make_shared<LayoutInfo>(
-            myScore, system, systemIndex, staff, i);
 
         if (isFirstStaff)
         {
@@ -110,54 +189,83 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
             height += layout->getSystemSymbolSpacing();
         }
 
-        myParentStaff = new StaffPainter(layout,
-                                         ScoreLocation(myScore, systemIndex, i),
-                                         myScoreArea->getClickPubSub());
-        myParentStaff->setPos(0, height);
-        myParentStaff->setParentItem(myParentSystem);
+        QGraphicsItem *staffItem = createStaff(system, systemIndex,
+                                               static_cast<int>(i), layout,
+                                               isFirstStaff);
+        staffItem->setPos(0, height);
+        staffItem->setParentItem(myParentSystem);
+        myStaffItems[i] = staffItem;
         height += layout->getStaffHeight();
+    }
 
-        if (isFirstStaff)
-            drawBarNumber(systemIndex, *layout);
-
-        // Draw the clefs.
-        const double CLEF_OFFSET =
-            (staff.getClefType() == Staff::TrebleClef) ? -6 : -21;
-        auto pubsub = myScoreArea->getClickPubSub();
-        const ScoreLocation location(myScore, systemIndex, i);
-        auto clef = new SimpleTextItem(staff.getClefType() == Staff::TrebleClef
-                                           ? QChar(MusicFont::TrebleClef)
-                                           : QChar(MusicFont::BassClef),
-                                       myMusicNotationFont);
-        auto group = new ClickableGroup(
-            QObject::tr("Click to change clef type."), [=]() {
-            pubsub->publish(ClickType::Clef, location);
-        });
-        group->addToGroup(clef);
-        group->setPos(LayoutInfo::CLEF_PADDING,
-                      layout->getTopStdNotationLine() + CLEF_OFFSET);
-        group->setParentItem(myParentStaff);
+    myParentSystem->setRect(0, 0, LayoutInfo::STAFF_WIDTH, height);
+    return myParentSystem;
+}
 
-        drawTabClef(LayoutInfo::CLEF_PADDING, *layout, location);
+QGraphicsItem *SystemRenderer::drawStaff(const System &system, int systemIndex,
+                                         int staffIndex,
+                                         const LayoutConstPtr &layout,
+                                         bool isFirstStaff)
+{
+    // Only the staff is being drawn, so skip any items that belong to the
+    // system.
+    myParentSystem = nullptr;
+    return createStaff(system, systemIndex, staffIndex, layout, isFirstStaff);
+}
 
-        drawBarlines(system, systemIndex, layout, location.getStaffIndex());
-        drawTabNotes(staff, layout);
-        drawLegato(staff, *layout);
-        drawSlides(staff, *layout);
+QGraphicsItem *SystemRenderer::createStaff(const System &system,
+                                           int systemIndex, int staffIndex,
+                                           const LayoutConstPtr &layout,
+                                           bool isFirstStaff)
+{
+    const Staff &staff = system.getStaves()[staffIndex];
 
-        drawSymbolsAboveStdNotationStaff(*layout);
-        drawSymbolsBelowStdNotationStaff(*layout);
-        drawSymbolsAboveTabStaff(staff, *layout);
-        drawSymbolsBelowTabStaff(*layout);
+    myParentStaff = new StaffPainter(
+        layout, ScoreLocation(myScore, systemIndex, staffIndex),
+        myScoreArea->getClickPubSub());
 
-        drawPlayerChanges(system, i, *layout);
-        drawStdNotation(system, staff, *layout);
+    if (isFirstStaff)
+        drawBarNumber(systemIndex, *layout);
 
-        ++i;
-    }
+    // Draw the clefs.
+    const double CLEF_OFFSET =
+        (staff.getClefType() == Staff::TrebleClef) ? -6 : -21;
+    auto pubsub = myScoreArea->getClickPubSub();
+    const ScoreLocation location(myScore, systemIndex, staffIndex);
+    auto clef = new SimpleTextItem(staff.getClefType() == Staff::TrebleClef
+                                       ? QChar(MusicFont::TrebleClef)
+                                       : QChar(MusicFont::BassClef),
+                                   myMusicNotationFont);
+    auto group = new ClickableGroup(
+        QObject::tr("Click to change clef type."), [=]() {
+        pubsub->publish(ClickType::Clef, location);
+    });
+    group->addToGroup(clef);
+    group->setPos(LayoutInfo::CLEF_PADDING,
+                  layout->getTopStdNotationLine() + CLEF_OFFSET);
+    group->setParentItem(myParentStaff);
 
-    myParentSystem->setRect(0, 0, LayoutInfo::STAFF_WIDTH, height);
-    return myParentSystem;
+    drawTabClef(LayoutInfo::CLEF_PADDING, *layout, location);
+
+    drawBarlines(system, systemIndex, layout, staffIndex);
+    drawTabNotes(staff, layout);
+    drawLegato(staff, *layout);
+    drawSlides(staff, *layout);
+
+    drawSymbolsAboveStdNotationStaff(*layout);
+    drawSymbolsBelowStdNotationStaff(*layout);
+    drawSymbolsAboveTabStaff(staff, *layout);
+    drawSymbolsBelowTabStaff(*layout);
+
+    drawPlayerChanges(system, staffIndex, *layout);
+    drawStdNotation(system, staff, *layout);
+
+    return myParentStaff;
+}
+
+const std::vector<QGraphicsItem *> &SystemRenderer::getStaffItems() const
+{
+    return myStaffItems;
 }
 
 void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
@@ -274,7 +382,8 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
             timeSigPainter->setParentItem(myParentStaff);
         }
 
-        if (barline.hasRehearsalSign() && staffIndex == 0)
+        // Rehearsal signs belong to the system rather than the staff.
+        if (barline.hasRehearsalSign() && staffIndex == 0 && myParentSystem)
         {
             const RehearsalSign &sign = barline.getRehearsalSign();
             const int RECTANGLE_OFFSET = 4;
@@ -23,6 +23,7 @@
 #include <painters/musicfont.h>
 #include <QFontMetricsF>
 #include <score/staff.h>
+#include <vector>
 
 class QGraphicsItem;
 class QGraphicsItemGroup;
@@ -39,9 +40,55 @@ public:
     SystemRenderer(const ScoreArea *score_area, const Score &score,
                    const ViewOptions &view_options);
 
+    /// Computes the layout of each staff in the system, including the
+    /// positions of notes, stems, beams and symbol groups. No graphics items
+    /// are created, so this can safely be run on a worker thread. Staves that
+    /// are hidden by the active view filter have a null layout.
+    static std::vector<LayoutConstPtr> computeLayouts(
+        const Score &score, const System &system, int systemIndex,
+        const ViewOptions &view_options);
+
+    /// Computes the layout of a single staff, or returns null if the staff
+    /// is hidden by the active view filter.
+    static LayoutConstPtr computeLayout(const Score &score,
+                                        const System &system, int systemIndex,
+                                        int staffIndex,
+                                        const ViewOptions &view_options);
+
+    /// Cheaply estimates the height of the system without computing its
+    /// layout, by ignoring the symbols above and below each staff.
+    static double estimateHeight(const Score &score, const System &system,
+                                 int systemIndex,
+                                 const ViewOptions &view_options);
+
     QGraphicsItem *operator()(const System &system, int systemIndex);
 
+    /// Creates the graphics items for the system from layouts that were
+    /// previously computed by computeLayouts(). This must be called from the
+    /// GUI thread.
+    QGraphicsItem *operator()(const System &system, int systemIndex,
+                              const std::vector<LayoutConstPtr> &layouts);
+
+    /// Creates the graphics items for a single staff. This can be used to
+    /// replace the staff in a previously rendered system, as long as the
+    /// staff's height and the system's position spacing have not changed.
+    /// @param isFirstStaff Whether this is the first visible staff in the
+    /// system, which also displays the bar number.
+    QGraphicsItem *drawStaff(const System &system, int systemIndex,
+                             int staffIndex, const LayoutConstPtr &layout,
+                             bool isFirstStaff);
+
+    /// Returns the items for each staff created by the last call to
+    /// operator(). Staves that are hidden have a null item.
+    const std::vector<QGraphicsItem *> &getStaffItems() const;
+
 private:
+    /// Creates the staff's items. Any system-level items are added to
+    /// myParentSystem, if it exists.
+    QGraphicsItem *createStaff(const System &system, int systemIndex,
+                               int staffIndex, const LayoutConstPtr &layout,
+                               bool isFirstStaff);
+
     /// Draws the tab clef.
     void drawTabClef(double x, const LayoutInfo &layout,
                      const ScoreLocation &location);
@@ -194,6 +241,7 @@ private:
 
     QGraphicsRectItem *myParentSystem;
     QGraphicsItem *myParentStaff;
+    std::vector<QGraphicsItem *> myStaffItems;
 
     QFont myMusicNotationFont;
     QFontMetricsF myMusicFontMetrics;
@@ -0,0 +1,175 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "systemtile.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+/// Paints the item and its children, in the same order and with the same
+/// opacity as QGraphicsScene. The opacity is relative to the root item, since
+/// the root is made transparent while its tile is displayed.
+static void recordItem(QPainter &painter, QGraphicsItem &root,
+                       QGraphicsItem &item, qreal parentOpacity)
+{
+    if (!item.isVisible())
+        return;
+
+    qreal opacity = (&item == &root) ? 1.0 : item.opacity();
+    if (!(item.flags() & QGraphicsItem::ItemIgnoresParentOpacity))
+        opacity *= parentOpacity;
+
+    const qreal childOpacity =
+        (item.flags() & QGraphicsItem::ItemDoesntPropagateOpacityToChildren)
+            ? parentOpacity
+            : opacity;
+
+    const QList<QGraphicsItem *> children = item.childItems();
+
+    for (QGraphicsItem *child : children)
+    {
+        if (child->flags() & QGraphicsItem::ItemStacksBehindParent)
+            recordItem(painter, root, *child, childOpacity);
+    }
+
+    if (!(item.flags() & QGraphicsItem::ItemHasNoContents) && opacity > 0)
+    {
+        QStyleOptionGraphicsItem option;
+        option.exposedRect = item.boundingRect();
+
+        painter.save();
+        painter.setTransform(item.itemTransform(&root), true);
+        painter.setOpacity(opacity);
+        item.paint(&painter, &option, nullptr);
+        painter.restore();
+    }
+
+    for (QGraphicsItem *child : children)
+    {
+        if (!(child->flags() & QGraphicsItem::ItemStacksBehindParent))
+            recordItem(painter, root, *child, childOpacity);
+    }
+}
+
+SystemTile::SystemTile(QGraphicsItem &system)
+    : mySystem(system),
+      myBounds(system.boundingRect() | system.childrenBoundingRect()),
+      myIsRecorded(false),
+      myImageScale(0)
+{
+    // The tile only displays the system, so mouse events should go to the
+    // system's items.
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void SystemTile::paint(QPainter *painter, const QStyleOptionGraphicsItem *,
+                       QWidget *)
+{
+    if (myImage.isNull())
+        return;
+
+    // If the image matches the current zoom level, blit it directly to the
+    // device. Otherwise, scale it until a new image is available.
+    const QTransform transform = painter->worldTransform();
+    if (transform.type() <= QTransform::TxScale &&
+        qFuzzyCompare(transform.m11(), myImageScale) &&
+        qFuzzyCompare(transform.m22(), myImageScale))
+    {
+        const QPointF origin = transform.map(myImageRect.topLeft());
+
+        painter->save();
+        painter->resetTransform();
+        painter->drawImage(QPoint(qRound(origin.x()), qRound(origin.y())),
+                           myImage);
+        painter->restore();
+    }
+    else
+        painter->drawImage(myImageRect, myImage);
+}
+
+QPicture SystemTile::getPicture()
+{
+    // Systems are often released again before their image is needed (e.g.
+    // while scrolling quickly), so only record them when necessary.
+    if (!myIsRecorded)
+    {
+        QPainter painter(&myPicture);
+        recordItem(painter, mySystem, mySystem, 1.0);
+        myIsRecorded = true;
+    }
+
+    // QPicture is implicitly shared, and replaying it modifies the shared
+    // data, so make a deep copy.
+    QPicture picture;
+    picture.setData(myPicture.data(), myPicture.size());
+    return picture;
+}
+
+QRectF SystemTile::getPictureRect() const
+{
+    return myBounds;
+}
+
+QImage SystemTile::rasterize(QPicture picture, const QRectF &bounds,
+                             double scale, double pixelRatio)
+{
+    const double pixelScale = scale * pixelRatio;
+    const QRect pixelRect =
+        QRectF(bounds.topLeft() * pixelScale, bounds.size() * pixelScale)
+            .toAlignedRect();
+
+    QImage image(pixelRect.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.translate(-pixelRect.topLeft());
+    painter.scale(pixelScale, pixelScale);
+    picture.play(&painter);
+    painter.end();
+
+    image.setDevicePixelRatio(pixelRatio);
+    return image;
+}
+
+void SystemTile::setImage(const QImage &image, double scale)
+{
+    prepareGeometryChange();
+
+    myImage = image;
+    myImageScale = scale;
+
+    // Compute the area that the image covers, which is aligned to the pixel
+    // grid at the image's zoom level.
+    const double pixelScale = scale * image.devicePixelRatio();
+    const QRect pixelRect =
+        QRectF(myBounds.topLeft() * pixelScale, myBounds.size() * pixelScale)
+            .toAlignedRect();
+    myImageRect = QRectF(QPointF(pixelRect.topLeft()) / pixelScale,
+                         QSizeF(pixelRect.size()) / pixelScale);
+
+    update();
+}
+
+bool SystemTile::hasImage() const
+{
+    return !myImage.isNull();
+}
+
+double SystemTile::getImageScale() const
+{
+    return myImageScale;
+}
@@ -0,0 +1,73 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_SYSTEMTILE_H
+#define PAINTERS_SYSTEMTILE_H
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPicture>
+
+/// Displays a pre-rendered image of a system, which is much faster to paint
+/// than the many items that make up the system. The system's items are
+/// recorded into a QPicture, which can then be rasterized for the current
+/// zoom level on a background thread.
+class SystemTile : public QGraphicsItem
+{
+public:
+    /// Creates a tile for the system, which must outlive the tile.
+    explicit SystemTile(QGraphicsItem &system);
+
+    virtual QRectF boundingRect() const override
+    {
+        return myBounds.united(myImageRect);
+    }
+
+    virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
+                       QWidget *) override;
+
+    /// Returns a copy of the recording, which can safely be used from another
+    /// thread. The system is recorded the first time this is called, which
+    /// must be from the GUI thread.
+    QPicture getPicture();
+    /// Returns the area covered by the recording, in item coordinates.
+    QRectF getPictureRect() const;
+
+    /// Renders a recording into an image, with the given zoom level and
+    /// device pixel ratio. This can be called from any thread.
+    static QImage rasterize(QPicture picture, const QRectF &bounds,
+                            double scale, double pixelRatio);
+
+    /// Sets the image to display, which was rasterized with the given zoom
+    /// level.
+    void setImage(const QImage &image, double scale);
+    bool hasImage() const;
+    double getImageScale() const;
+
+private:
+    QGraphicsItem &mySystem;
+    /// The area covered by the system's items.
+    QRectF myBounds;
+    bool myIsRecorded;
+    QPicture myPicture;
+    QImage myImage;
+    double myImageScale;
+    /// The area covered by the image, in item coordinates.
+    QRectF myImageRect;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binaryserialization.h"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace ScoreUtils
+{
+/// Identifies a binary archive. A JSON document cannot start with this.
+static const char theMagic[] = { 'P', 'T', 'B', '\x01' };
+static const size_t theMagicSize = sizeof(theMagic);
+
+BinaryInputArchive::BinaryInputArchive(std::istream &is)
+    : myBuffer(is.rdbuf())
+{
+    if (!is || !myBuffer)
+        throw std::runtime_error("Could not open stream");
+
+    char magic[theMagicSize];
+    if (myBuffer->sgetn(magic, theMagicSize) !=
+            static_cast<std::streamsize>(theMagicSize) ||
+        std::memcmp(magic, theMagic, theMagicSize) != 0)
+    {
+        throw std::runtime_error("Not a binary score archive");
+    }
+
+    (*this)("version", myVersion);
+}
+
+FileVersion BinaryInputArchive::version() const
+{
+    return myVersion;
+}
+
+bool isBinaryArchive(std::istream &is)
+{
+    // Only the first byte is needed to distinguish from JSON, and peeking
+    // does not consume any input from e.g. a decompression filter.
+    const auto c = is.peek();
+    return c != std::char_traits<char>::eof() && c == theMagic[0];
+}
+
+BinaryOutputArchive::BinaryOutputArchive(std::ostream &os, FileVersion version)
+    : myBuffer(os.rdbuf()), myVersion(version)
+{
+    if (!os || !myBuffer)
+        throw std::runtime_error("Could not open stream");
+
+    myBuffer->sputn(theMagic, theMagicSize);
+    (*this)("version", myVersion);
+}
+}
@@ -0,0 +1,492 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_BINARYSERIALIZATION_H
+#define SCORE_BINARYSERIALIZATION_H
+
+#include <array>
+#include <boost/container/small_vector.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/optional.hpp>
+#include <bitset>
+#include <cstdint>
+#include "fileversion.h"
+#include <iosfwd>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <util/copyonwrite.h>
+#include <vector>
+
+/// A compact binary encoding for the score, which uses the same serialize()
+/// methods as the JSON format. Member names are not stored, so members are
+/// read back in the order that they were written. Integers are stored as
+/// variable-length quantities (7 bits per byte, with the high bit set on all
+/// but the last byte) and signed values are zigzag-encoded.
+namespace ScoreUtils
+{
+class BinaryInputArchive
+{
+public:
+    BinaryInputArchive(std::istream &is);
+
+    FileVersion version() const;
+
+    template <typename T>
+    void operator()(const std::string &, T &obj)
+    {
+        read(obj);
+    }
+
+private:
+    inline uint8_t readByte();
+    inline uint64_t readVarint();
+    /// Throws if a string or sequence's length is larger than any valid
+    /// score would need.
+    inline void checkLength(unsigned int length) const;
+    inline int64_t readSignedVarint();
+
+    inline void read(int &val);
+    inline void read(int8_t &val);
+    inline void read(unsigned int &val);
+    inline void read(uint8_t &val);
+    inline void read(bool &val);
+    inline void read(std::string &str);
+
+    template <typename T>
+    void read(std::vector<T> &vec)
+    {
+        readSequence(vec);
+    }
+
+    template <typename T, size_t N>
+    void read(boost::container::small_vector<T, N> &vec)
+    {
+        readSequence(vec);
+    }
+
+    template <typename Sequence>
+    void readSequence(Sequence &vec);
+
+    template <typename K, typename V, typename C>
+    void read(std::map<K, V, C> &map);
+
+    template <typename T, size_t N>
+    void read(std::array<T, N> &arr);
+
+    template <size_t N>
+    void read(std::bitset<N> &bits);
+
+    template <typename T>
+    void read(boost::optional<T> &val);
+
+    template <typename T>
+    void read(CopyOnWrite<T> &val)
+    {
+        read(val.getMutable());
+    }
+
+    inline void read(boost::gregorian::date &date);
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type read(T &val)
+    {
+        int int_val;
+        read(int_val);
+        val = static_cast<T>(int_val);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_class<T>::value>::type read(T &obj)
+    {
+        obj.serialize(*this, myVersion);
+    }
+
+    std::streambuf *myBuffer;
+    FileVersion myVersion;
+};
+
+/// Returns true if the stream contains a binary archive rather than JSON.
+/// The stream's position is not changed.
+bool isBinaryArchive(std::istream &is);
+
+template <typename T>
+void loadBinary(std::istream &input, const std::string &name, T &obj)
+{
+    BinaryInputArchive archive(input);
+    if (archive.version() > FileVersion::LATEST_VERSION ||
+        archive.version() < FileVersion::INITIAL_VERSION)
+    {
+        throw std::runtime_error("Invalid file version");
+    }
+
+    archive(name, obj);
+}
+
+class BinaryOutputArchive
+{
+public:
+    BinaryOutputArchive(std::ostream &os, FileVersion version);
+
+    template <typename T>
+    void operator()(const std::string &, const T &obj)
+    {
+        write(obj);
+    }
+
+private:
+    inline void writeByte(uint8_t val);
+    inline void writeVarint(uint64_t val);
+    inline void writeSignedVarint(int64_t val);
+
+    inline void write(int val);
+    inline void write(int8_t val);
+    inline void write(unsigned int val);
+    inline void write(uint8_t val);
+    inline void write(bool val);
+    inline void write(const std::string &str);
+
+    template <typename T>
+    void write(const std::vector<T> &vec)
+    {
+        writeSequence(vec);
+    }
+
+    template <typename T, size_t N>
+    void write(const boost::container::small_vector<T, N> &vec)
+    {
+        writeSequence(vec);
+    }
+
+    template <typename Sequence>
+    void writeSequence(const Sequence &vec);
+
+    template <typename K, typename V, typename C>
+    void write(const std::map<K, V, C> &map);
+
+    template <typename T, size_t N>
+    void write(const std::array<T, N> &arr);
+
+    template <size_t N>
+    void write(const std::bitset<N> &bits);
+
+    template <typename T>
+    void write(const boost::optional<T> &val);
+
+    template <typename T>
+    void write(const CopyOnWrite<T> &val)
+    {
+        write(val.get());
+    }
+
+    inline void write(const boost::gregorian::date &date);
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type write(const T &val)
+    {
+        write(static_cast<int>(val));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_class<T>::value>::type write(const T &obj)
+    {
+        const_cast<T &>(obj).serialize(*this, myVersion);
+    }
+
+    std::streambuf *myBuffer;
+    const FileVersion myVersion;
+};
+
+template <typename T>
+void saveBinary(std::ostream &output, const std::string &name, const T &obj)
+{
+    BinaryOutputArchive ar(output, FileVersion::LATEST_VERSION);
+    ar(name, obj);
+}
+
+uint8_t BinaryInputArchive::readByte()
+{
+    const auto c = myBuffer->sbumpc();
+    if (c == std::char_traits<char>::eof())
+        throw std::runtime_error("Unexpected end of binary data");
+
+    return static_cast<uint8_t>(c);
+}
+
+uint64_t BinaryInputArchive::readVarint()
+{
+    uint64_t val = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        const uint8_t byte = readByte();
+        val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return val;
+    }
+
+    throw std::runtime_error("Invalid variable-length integer");
+}
+
+void BinaryInputArchive::checkLength(unsigned int length) const
+{
+    // The stream's size is not known in advance (e.g. a decompression
+    // filter), so use a fixed limit rather than allocating whatever a
+    // corrupted length requests.
+    static const unsigned int theMaxLength = 1 << 24;
+    if (length > theMaxLength)
+        throw std::runtime_error("Invalid length in binary data");
+}
+
+int64_t BinaryInputArchive::readSignedVarint()
+{
+    const uint64_t val = readVarint();
+    return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+}
+
+void BinaryInputArchive::read(int &val)
+{
+    const int64_t int_val = readSignedVarint();
+    if (int_val > std::numeric_limits<int>::max() ||
+        int_val < std::numeric_limits<int>::min())
+    {
+        throw std::overflow_error("Invalid int value");
+    }
+    val = static_cast<int>(int_val);
+}
+
+void BinaryInputArchive::read(int8_t &val)
+{
+    val = static_cast<int8_t>(readByte());
+}
+
+void BinaryInputArchive::read(unsigned int &val)
+{
+    const uint64_t uint_val = readVarint();
+    if (uint_val > std::numeric_limits<unsigned int>::max())
+        throw std::overflow_error("Invalid unsigned int value");
+    val = static_cast<unsigned int>(uint_val);
+}
+
+void BinaryInputArchive::read(uint8_t &val)
+{
+    val = readByte();
+}
+
+void BinaryInputArchive::read(bool &val)
+{
+    val = readByte() != 0;
+}
+
+void BinaryInputArchive::read(std::string &str)
+{
+    unsigned int length;
+    read(length);
+    checkLength(length);
+
+    str.resize(length);
+    if (length != 0 &&
+        myBuffer->sgetn(&str[0], length) != static_cast<std::streamsize>(length))
+    {
+        throw std::runtime_error("Unexpected end of binary data");
+    }
+}
+
+template <typename Sequence>
+void BinaryInputArchive::readSequence(Sequence &vec)
+{
+    unsigned int size;
+    read(size);
+    checkLength(size);
+
+    // Add the elements as they are read, so that a corrupted size fails at the
+    // end of the data instead of allocating every element up front.
+    vec.clear();
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        vec.emplace_back();
+        read(vec.back());
+    }
+}
+
+template <typename K, typename V, typename C>
+void BinaryInputArchive::read(std::map<K, V, C> &map)
+{
+    unsigned int size;
+    read(size);
+    checkLength(size);
+
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        K key;
+        read(key);
+        read(map[key]);
+    }
+}
+
+template <typename T, size_t N>
+void BinaryInputArchive::read(std::array<T, N> &arr)
+{
+    for (T &obj : arr)
+        read(obj);
+}
+
+template <size_t N>
+void BinaryInputArchive::read(std::bitset<N> &bits)
+{
+    bits.reset();
+    for (size_t i = 0; i < N; i += 8)
+    {
+        const uint8_t byte = readByte();
+        for (size_t j = 0; j < 8 && i + j < N; ++j)
+            bits[i + j] = (byte >> j) & 1;
+    }
+}
+
+template <typename T>
+void BinaryInputArchive::read(boost::optional<T> &val)
+{
+    bool has_value;
+    read(has_value);
+
+    if (has_value)
+    {
+        T data;
+        read(data);
+        val.reset(data);
+    }
+    else
+        val.reset();
+}
+
+void BinaryInputArchive::read(boost::gregorian::date &date)
+{
+    std::string date_str;
+    read(date_str);
+    date = boost::gregorian::from_undelimited_string(date_str);
+}
+
+void BinaryOutputArchive::writeByte(uint8_t val)
+{
+    myBuffer->sputc(static_cast<char>(val));
+}
+
+void BinaryOutputArchive::writeVarint(uint64_t val)
+{
+    while (val >= 0x80)
+    {
+        writeByte(static_cast<uint8_t>(val | 0x80));
+        val >>= 7;
+    }
+
+    writeByte(static_cast<uint8_t>(val));
+}
+
+void BinaryOutputArchive::writeSignedVarint(int64_t val)
+{
+    writeVarint((static_cast<uint64_t>(val) << 1) ^
+                static_cast<uint64_t>(val >> 63));
+}
+
+void BinaryOutputArchive::write(int val)
+{
+    writeSignedVarint(val);
+}
+
+void BinaryOutputArchive::write(int8_t val)
+{
+    writeByte(static_cast<uint8_t>(val));
+}
+
+void BinaryOutputArchive::write(unsigned int val)
+{
+    writeVarint(val);
+}
+
+void BinaryOutputArchive::write(uint8_t val)
+{
+    writeByte(val);
+}
+
+void BinaryOutputArchive::write(bool val)
+{
+    writeByte(val ? 1 : 0);
+}
+
+void BinaryOutputArchive::write(const std::string &str)
+{
+    write(static_cast<unsigned int>(str.length()));
+    myBuffer->sputn(str.data(), str.length());
+}
+
+template <typename Sequence>
+void BinaryOutputArchive::writeSequence(const Sequence &vec)
+{
+    write(static_cast<unsigned int>(vec.size()));
+    for (const auto &obj : vec)
+        write(obj);
+}
+
+template <typename K, typename V, typename C>
+void BinaryOutputArchive::write(const std::map<K, V, C> &map)
+{
+    write(static_cast<unsigned int>(map.size()));
+    for (const auto &pair : map)
+    {
+        write(pair.first);
+        write(pair.second);
+    }
+}
+
+template <typename T, size_t N>
+void BinaryOutputArchive::write(const std::array<T, N> &arr)
+{
+    for (const T &obj : arr)
+        write(obj);
+}
+
+template <size_t N>
+void BinaryOutputArchive::write(const std::bitset<N> &bits)
+{
+    for (size_t i = 0; i < N; i += 8)
+    {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < 8 && i + j < N; ++j)
+            byte |= static_cast<uint8_t>(bits[i + j]) << j;
+
+        writeByte(byte);
+    }
+}
+
+template <typename T>
+void BinaryOutputArchive::write(const boost::optional<T> &val)
+{
+    write(static_cast<bool>(val));
+    if (val)
+        write(*val);
+}
+
+void BinaryOutputArchive::write(const boost::gregorian::date &date)
+{
+    write(boost::gregorian::to_iso_string(date));
+}
+}
+
+#endif
@@ -17,10 +17,12 @@
 
 #include "note.h"
 
+#include <limits>
 #include <map>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
+#include "tuning.h"
 
 const int Note::MIN_FRET_NUMBER = 0;
 const int Note::MAX_FRET_NUMBER = 29;
@@ -36,30 +38,50 @@ namespace {
     };
 }
 
+static_assert(Note::NumSimpleProperties <= 32,
+              "Note properties must fit in 32 bits");
+
+/// Converts a fret number to the compact representation.
+static int8_t toCompactFret(int fret)
+{
+    if (fret < 0 || fret > std::numeric_limits<int8_t>::max())
+        throw std::out_of_range("Invalid fret number");
+
+    return static_cast<int8_t>(fret);
+}
+
 Note::Note()
     : myString(0),
       myFretNumber(0),
       myTrilledFret(-1),
-      myTappedHarmonicFret(-1)
+      myTappedHarmonicFret(-1),
+      mySimpleProperties(0)
 {
 }
 
 Note::Note(int string, int fretNumber)
-    : myString(string),
-      myFretNumber(fretNumber),
+    : myString(0),
+      myFretNumber(0),
       myTrilledFret(-1),
-      myTappedHarmonicFret(-1)
+      myTappedHarmonicFret(-1),
+      mySimpleProperties(0)
 {
+    setString(string);
+    setFretNumber(fretNumber);
 }
 
 bool Note::operator==(const Note &other) const
 {
+    static const Extras theNoExtras;
+    const Extras &extras = myExtras ? *myExtras : theNoExtras;
+    const Extras &other_extras = other.myExtras ? *other.myExtras : theNoExtras;
+
     return myString == other.myString && myFretNumber == other.myFretNumber &&
            mySimpleProperties == other.mySimpleProperties &&
            myTrilledFret == other.myTrilledFret &&
            myTappedHarmonicFret == other.myTappedHarmonicFret &&
-           myArtificialHarmonic == other.myArtificialHarmonic &&
-           myBend == other.myBend;
+           extras.myArtificialHarmonic == other_extras.myArtificialHarmonic &&
+           extras.myBend == other_extras.myBend;
 }
 
 int Note::getString() const
@@ -69,7 +91,10 @@ int Note::getString() const
 
 void Note::setString(int string)
 {
-    myString = string;
+    if (string < 0 || string >= Tuning::MAX_STRING_COUNT)
+        throw std::out_of_range("Invalid string");
+
+    myString = static_cast<int8_t>(string);
 }
 
 int Note::getFretNumber() const
@@ -79,12 +104,12 @@ int Note::getFretNumber() const
 
 void Note::setFretNumber(int fret)
 {
-    myFretNumber = fret;
+    myFretNumber = toCompactFret(fret);
 }
 
 bool Note::hasProperty(SimpleProperty property) const
 {
-    return mySimpleProperties.test(property);
+    return (mySimpleProperties >> property) & 1;
 }
 
 void Note::setProperty(SimpleProperty property, bool set)
@@ -96,30 +121,33 @@ void Note::setProperty(SimpleProperty property, bool set)
         if (property >= Octave8va && property <= Octave15mb)
         {
             for (int p = Octave8va; p <= Octave15mb; ++p)
-                mySimpleProperties.set(static_cast<SimpleProperty>(p), false);
+                mySimpleProperties &= ~(1u << p);
         }
 
         // Clear all hammeron/pulloff properties.
         if (property >= HammerOnOrPullOff && property <= PullOffToNowhere)
         {
             for (int p = HammerOnOrPullOff; p <= PullOffToNowhere; ++p)
-                mySimpleProperties.set(static_cast<SimpleProperty>(p), false);
+                mySimpleProperties &= ~(1u << p);
         }
 
         // Clear any mutually-exclusive slide types.
         if (property == SlideIntoFromAbove)
-            mySimpleProperties.set(SlideIntoFromBelow, false);
+            mySimpleProperties &= ~(1u << SlideIntoFromBelow);
         if (property == SlideIntoFromBelow)
-            mySimpleProperties.set(SlideIntoFromAbove, false);
+            mySimpleProperties &= ~(1u << SlideIntoFromAbove);
 
         if (property >= ShiftSlide && property <= SlideOutOfUpwards)
         {
             for (int p = ShiftSlide; p <= SlideOutOfUpwards; ++p)
-                mySimpleProperties.set(static_cast<SimpleProperty>(p), false);
+                mySimpleProperties &= ~(1u << p);
         }
     }
 
-    mySimpleProperties.set(property, set);
+    if (set)
+        mySimpleProperties |= 1u << property;
+    else
+        mySimpleProperties &= ~(1u << property);
 }
 
 bool Note::hasTrill() const
@@ -137,10 +165,7 @@ int Note::getTrilledFret() const
 
 void Note::setTrilledFret(int fret)
 {
-    if (fret < 0)
-        throw std::out_of_range("Invalid fret number");
-
-    myTrilledFret = fret;
+    myTrilledFret = toCompactFret(fret);
 }
 
 void Note::clearTrill()
@@ -163,10 +188,7 @@ int Note::getTappedHarmonicFret() const
 
 void Note::setTappedHarmonicFret(int fret)
 {
-    if (fret < 0)
-        throw std::out_of_range("Invalid fret number");
-
-    myTappedHarmonicFret = fret;
+    myTappedHarmonicFret = toCompactFret(fret);
 }
 
 void Note::clearTappedHarmonic()
@@ -176,62 +198,100 @@ void Note::clearTappedHarmonic()
 
 bool Note::hasArtificialHarmonic() const
 {
-    return myArtificialHarmonic.is_initialized();
+    return myExtras && myExtras->myArtificialHarmonic.is_initialized();
 }
 
 const ArtificialHarmonic &Note::getArtificialHarmonic() const
 {
-    return myArtificialHarmonic.get();
+    return myExtras->myArtificialHarmonic.get();
 }
 
 void Note::setArtificialHarmonic(const ArtificialHarmonic &harmonic)
 {
-    myArtificialHarmonic = harmonic;
+    Extras extras = getExtras();
+    extras.myArtificialHarmonic = harmonic;
+    setExtras(extras);
 }
 
 void Note::clearArtificialHarmonic()
 {
-    myArtificialHarmonic.reset();
+    Extras extras = getExtras();
+    extras.myArtificialHarmonic.reset();
+    setExtras(extras);
 }
 
 bool Note::hasBend() const
 {
-    return myBend.is_initialized();
+    return myExtras && myExtras->myBend.is_initialized();
 }
 
 const Bend &Note::getBend() const
 {
-    return myBend.get();
+    return myExtras->myBend.get();
 }
 
 void Note::setBend(const Bend &bend)
 {
-    myBend = bend;
+    Extras extras = getExtras();
+    extras.myBend = bend;
+    setExtras(extras);
 }
 
 void Note::clearBend()
 {
-    myBend.reset();
+    Extras extras = getExtras();
+    extras.myBend.reset();
+    setExtras(extras);
 }
 
 bool Note::hasLeftHandFingering() const
 {
-    return myLeftHandFingering.is_initialized();
+    return myExtras && myExtras->myLeftHandFingering.is_initialized();
 }
 
 const LeftHandFingering &Note::getLeftHandFingering() const
 {
-    return myLeftHandFingering.get();
+    return myExtras->myLeftHandFingering.get();
 }
 
 void Note::setLeftHandFingering(const LeftHandFingering &fingering)
 {
-    myLeftHandFingering = fingering;
+    Extras extras = getExtras();
+    extras.myLeftHandFingering = fingering;
+    setExtras(extras);
 }
 
 void Note::clearLeftHandFingering()
 {
-    myLeftHandFingering.reset();
+    Extras extras = getExtras();
+    extras.myLeftHandFingering.reset();
+    setExtras(extras);
+}
+
+bool Note::Extras::operator==(const Extras &other) const
+{
+    return myArtificialHarmonic == other.myArtificialHarmonic &&
+           myBend == other.myBend &&
+           myLeftHandFingering == other.myLeftHandFingering;
+}
+
+bool Note::Extras::empty() const
+{
+    return !myArtificialHarmonic && !myBend && !myLeftHandFingering;
+}
+
+Note::Extras Note::getExtras() const
+{
+    return myExtras ? *myExtras : Extras();
+}
+
+void Note::setExtras(const Extras &extras)
+{
+    if (extras.empty())
+        myExtras.reset();
+    // Avoid replacing the shared data if nothing changed (e.g. when saving).
+    else if (!myExtras || !(*myExtras == extras))
+        myExtras = std::make_shared<const Extras>(extras);
 }
 
 std::ostream &operator<<(std::ostream &os, const Note &note)
@@ -21,8 +21,10 @@
 #include <bitset>
 #include <boost/optional.hpp>
 #include "chordname.h"
+#include <cstdint>
 #include "fileversion.h"
 #include <iosfwd>
+#include <memory>
 #include <vector>
 
 class ArtificialHarmonic
@@ -263,28 +265,67 @@ public:
     static const int MAX_FRET_NUMBER;
 
 private:
-    int myString;
-    int myFretNumber;
-    std::bitset<NumSimpleProperties> mySimpleProperties;
-    int myTrilledFret;
-    int myTappedHarmonicFret;
-    boost::optional<ArtificialHarmonic> myArtificialHarmonic;
-    boost::optional<Bend> myBend;
-    boost::optional<LeftHandFingering> myLeftHandFingering;
+    /// Rarely used properties, which are stored separately so that the common
+    /// case of a plain note stays small. This is shared between copies of the
+    /// note, and is replaced rather than modified.
+    struct Extras
+    {
+        bool operator==(const Extras &other) const;
+        bool empty() const;
+
+        boost::optional<ArtificialHarmonic> myArtificialHarmonic;
+        boost::optional<Bend> myBend;
+        boost::optional<LeftHandFingering> myLeftHandFingering;
+    };
+
+    Extras getExtras() const;
+    void setExtras(const Extras &extras);
+
+    int8_t myString;
+    int8_t myFretNumber;
+    int8_t myTrilledFret;
+    int8_t myTappedHarmonicFret;
+    uint32_t mySimpleProperties;
+    std::shared_ptr<const Extras> myExtras;
 };
 
 template <class Archive>
 void Note::serialize(Archive &ar, const FileVersion version)
 {
-    ar("string", myString);
-    ar("fret", myFretNumber);
-    ar("properties", mySimpleProperties);
-    ar("trill", myTrilledFret);
-    ar("tapped_harmonic", myTappedHarmonicFret);
-    ar("artificial_harmonic", myArtificialHarmonic);
-    ar("bend", myBend);
+    // Convert between the compact representation and the file format. The
+    // setters reject values that are out of range.
+    int string = myString;
+    ar("string", string);
+    setString(string);
+
+    int fret = myFretNumber;
+    ar("fret", fret);
+    setFretNumber(fret);
+
+    std::bitset<NumSimpleProperties> properties(mySimpleProperties);
+    ar("properties", properties);
+    mySimpleProperties = static_cast<uint32_t>(properties.to_ulong());
+
+    int trill = myTrilledFret;
+    ar("trill", trill);
+    if (trill == -1)
+        clearTrill();
+    else
+        setTrilledFret(trill);
+
+    int tapped_harmonic = myTappedHarmonicFret;
+    ar("tapped_harmonic", tapped_harmonic);
+    if (tapped_harmonic == -1)
+        clearTappedHarmonic();
+    else
+        setTappedHarmonicFret(tapped_harmonic);
+
+    Extras extras = getExtras();
+    ar("artificial_harmonic", extras.myArtificialHarmonic);
+    ar("bend", extras.myBend);
     if (version >= FileVersion::LEFT_HAND_FINGERING)
-        ar("finger_hint", myLeftHandFingering);
+        ar("finger_hint", extras.myLeftHandFingering);
+    setExtras(extras);
 }
 
 /// Useful utility functions for working with natural and tapped harmonics.
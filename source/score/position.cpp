@@ -158,12 +158,25 @@ boost::iterator_range<Position::NoteConstIterator> Position::getNotes() const
 
 void Position::insertNote(const Note &note)
 {
-    myNotes.push_back(note);
+    insertNote(Note(note));
+}
+
+void Position::insertNote(Note &&note)
+{
+    // Keep the notes sorted by string, but avoid sorting when the notes are
+    // inserted in order.
+    const bool needsSort =
+        !myNotes.empty() && myNotes.back().getString() > note.getString();
 
-    // Sort notes by string.
-    std::sort(myNotes.begin(), myNotes.end(), [](const Note &note1, const Note &note2) {
-        return note1.getString() < note2.getString();
-    });
+    myNotes.push_back(std::move(note));
+
+    if (needsSort)
+    {
+        std::sort(myNotes.begin(), myNotes.end(),
+                  [](const Note &note1, const Note &note2) {
+                      return note1.getString() < note2.getString();
+                  });
+    }
 }
 
 void Position::removeNote(const Note &note)
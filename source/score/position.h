@@ -19,17 +19,24 @@
 #define SCORE_POSITION_H
 
 #include <algorithm>
+#include <boost/container/small_vector.hpp>
 #include <boost/range/iterator_range_core.hpp>
 #include <bitset>
+#include <cstddef>
 #include "fileversion.h"
 #include "note.h"
-#include <vector>
 
 class Position
 {
 public:
-    typedef std::vector<Note>::iterator NoteIterator;
-    typedef std::vector<Note>::const_iterator NoteConstIterator;
+    /// The number of notes that can be stored without a separate allocation.
+    /// Most positions are a single note or a rest.
+    static const size_t INLINE_NOTE_CAPACITY = 1;
+
+    typedef boost::container::small_vector<Note, INLINE_NOTE_CAPACITY>
+        NoteList;
+    typedef NoteList::iterator NoteIterator;
+    typedef NoteList::const_iterator NoteConstIterator;
 
     enum DurationType
     {
@@ -112,6 +119,7 @@ public:
 
     /// Adds a new note to the position.
     void insertNote(const Note &note);
+    void insertNote(Note &&note);
     /// Removes any notes that satisfy the given predicate.
     template <class Predicate>
     void removeNotes(Predicate p);
@@ -123,7 +131,7 @@ private:
     DurationType myDurationType;
     std::bitset<NumSimpleProperties> mySimpleProperties;
     int myMultiBarRestCount;
-    std::vector<Note> myNotes;
+    NoteList myNotes;
 };
 
 template <class Archive>
@@ -17,6 +17,8 @@
 
 #include "score.h"
 
+#include <algorithm>
+
 const int Score::MIN_LINE_SPACING = 6;
 const int Score::MAX_LINE_SPACING = 14;
 
@@ -55,16 +57,27 @@ boost::iterator_range<Score::SystemConstIterator> Score::getSystems() const
 }
 
 void Score::insertSystem(const System &system, int index)
+{
+    insertSystem(System(system), index);
+}
+
+void Score::insertSystem(System &&system, int index)
 {
     if (index < 0)
-        mySystems.push_back(system);
+    {
+        mySystems.push_back(std::move(system));
+        index = static_cast<int>(mySystems.size()) - 1;
+    }
     else
-        mySystems.insert(mySystems.begin() + index, system);
+        mySystems.insert(mySystems.begin() + index, std::move(system));
+
+    updatePlayerChangeIndex(index);
 }
 
 void Score::removeSystem(int index)
 {
     mySystems.erase(mySystems.begin() + index);
+    updatePlayerChangeIndex(index);
 }
 
 boost::iterator_range<Score::PlayerIterator> Score::getPlayers()
@@ -150,31 +163,72 @@ void Score::setLineSpacing(int value)
     myLineSpacing = value;
 }
 
-const PlayerChange *ScoreUtils::getCurrentPlayers(const Score &score,
-                                                  int systemIndex,
-                                                  int positionIndex)
+const PlayerChange *Score::getCurrentPlayers(int systemIndex,
+                                             int positionIndex) const
 {
-    const PlayerChange *lastChange = nullptr;
+    const int numSystems = static_cast<int>(mySystems.size());
 
-    int i = 0;
-    for (const System &system : score.getSystems())
+    // First, look for a player change at or before the position in the
+    // current system. Player changes are kept sorted by position.
+    if (systemIndex < numSystems)
     {
-        if (i > systemIndex)
-            break;
+        auto changes = mySystems[systemIndex].getPlayerChanges();
+        auto it = std::upper_bound(
+            changes.begin(), changes.end(), positionIndex,
+            [](int position, const PlayerChange &change) {
+                return position < change.getPosition();
+            });
+
+        if (it != changes.begin())
+            return &*(it - 1);
+    }
+
+    // Otherwise, use the last player change from an earlier system.
+    const int prevSystem = std::min(systemIndex, numSystems) - 1;
+    if (prevSystem < 0)
+        return nullptr;
 
-        for (const PlayerChange &change : system.getPlayerChanges())
+    int i = myPlayerChangeIndex[prevSystem];
+
+    // If a system was modified without refreshing the index, the indexed
+    // system may no longer have any player changes. Fall back to searching
+    // backwards rather than returning an invalid player change.
+    if (i >= 0 && mySystems[i].getPlayerChanges().empty())
+    {
+        for (i = prevSystem; i >= 0; --i)
         {
-            if (i < systemIndex ||
-               (i == systemIndex && change.getPosition() <= positionIndex))
-            {
-                lastChange = &change;
-            }
+            if (!mySystems[i].getPlayerChanges().empty())
+                break;
         }
+    }
+
+    return (i >= 0) ? &mySystems[i].getPlayerChanges().back() : nullptr;
+}
+
+void Score::updatePlayerChangeIndex(int systemIndex)
+{
+    const int numSystems = static_cast<int>(mySystems.size());
+    myPlayerChangeIndex.resize(mySystems.size());
+
+    // The entries before the modified system are still valid.
+    systemIndex = std::max(0, std::min(systemIndex, numSystems));
+    int lastChange =
+        (systemIndex > 0) ? myPlayerChangeIndex[systemIndex - 1] : -1;
 
-        ++i;
+    for (int i = systemIndex; i < numSystems; ++i)
+    {
+        if (!mySystems[i].getPlayerChanges().empty())
+            lastChange = i;
+
+        myPlayerChangeIndex[i] = lastChange;
     }
+}
 
-    return lastChange;
+const PlayerChange *ScoreUtils::getCurrentPlayers(const Score &score,
+                                                  int systemIndex,
+                                                  int positionIndex)
+{
+    return score.getCurrentPlayers(systemIndex, positionIndex);
 }
 
 void ScoreUtils::adjustRehearsalSigns(Score &score)
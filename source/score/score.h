@@ -61,6 +61,7 @@ public:
 
     /// Adds a new system to the score, optionally at a specific index.
     void insertSystem(const System &system, int index = -1);
+    void insertSystem(System &&system, int index = -1);
     /// Removes the specified system from the score.
     void removeSystem(int index);
 
@@ -101,6 +102,19 @@ public:
     /// Sets the spacing between tabulature lines for the score.
     void setLineSpacing(int value);
 
+    /// Returns the player change that is active at the given location, or
+    /// null if there is no player change before that location.
+    /// This uses the player change index, so it does not need to scan the
+    /// preceding systems.
+    const PlayerChange *getCurrentPlayers(int systemIndex,
+                                          int positionIndex) const;
+
+    /// Updates the player change index after player changes were directly
+    /// added to or removed from the given system (e.g. via
+    /// System::insertPlayerChange). The entries for all following systems
+    /// are recomputed as well.
+    void updatePlayerChangeIndex(int systemIndex);
+
     static const int MIN_LINE_SPACING;
     static const int MAX_LINE_SPACING;
 
@@ -112,6 +126,9 @@ private:
     std::vector<Instrument> myInstruments;
     int myLineSpacing; ///< Spacing between tab lines (in pixels).
     std::vector<ViewFilter> myViewFilters;
+    /// For each system, the index of the last system at or before it that
+    /// contains a player change, or -1 if there is no such system.
+    std::vector<int> myPlayerChangeIndex;
 };
 
 template <class Archive>
@@ -125,10 +142,13 @@ void Score::serialize(Archive &ar, const FileVersion version)
 
     if (version >= FileVersion::VIEW_FILTERS)
         ar("view_filters", myViewFilters);
+
+    updatePlayerChangeIndex(0);
 }
 
 namespace ScoreUtils {
 /// Get the current player change for the given position.
+/// This is equivalent to Score::getCurrentPlayers().
 const PlayerChange *getCurrentPlayers(const Score &score, int systemIndex,
                                       int positionIndex);
 
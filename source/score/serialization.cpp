@@ -17,33 +17,228 @@
 
 #include "serialization.h"
 
-#include <rapidjson/error/en.h>
+#include <istream>
 
 namespace ScoreUtils
 {
-InputArchive::InputArchive(std::istream &is) : myStream(is)
+InputArchive::InputArchive(std::istream &is)
+    : myBuffer(is.rdbuf()), myOffset(0), myIsFirstItem(true)
 {
-    if (!is)
+    if (!is || !myBuffer)
         throw std::runtime_error("Could not open stream");
 
-    myDocument.ParseStream<0>(myStream);
+    skipWhitespace();
+    expect('{');
 
-    if (myDocument.HasParseError())
+    (*this)("version", myVersion);
+}
+
+FileVersion InputArchive::version() const
+{
+    return myVersion;
+}
+
+void InputArchive::throwUnexpected(const std::string &found,
+                                   const std::string &expected) const
+{
+    throw std::runtime_error(
+        std::string("Unexpected or missing JSON data: found ") + found +
+        ", expected " + expected);
+}
+
+void InputArchive::throwParseError(const std::string &msg) const
+{
+    throw std::runtime_error("Parse error at offset " +
+                             std::to_string(myOffset) + ": " + msg);
+}
+
+/// Appends the UTF-8 encoding of a code point.
+static void appendUtf8(std::string &str, unsigned int code)
+{
+    if (code < 0x80)
+        str += static_cast<char>(code);
+    else if (code < 0x800)
+    {
+        str += static_cast<char>(0xC0 | (code >> 6));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
     {
-        throw std::runtime_error("Parse error at offset " +
-                                 std::to_string(myDocument.GetErrorOffset()) +
-                                 ": " +
-                                 GetParseError_En(myDocument.GetParseError()));
+        str += static_cast<char>(0xE0 | (code >> 12));
+        str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (code & 0x3F));
     }
+    else
+    {
+        str += static_cast<char>(0xF0 | (code >> 18));
+        str += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+void InputArchive::readString(std::string &str)
+{
+    skipWhitespace();
+    expect('"');
 
-    myIterators.push(myDocument.MemberBegin());
+    str.clear();
 
-    (*this)("version", myVersion);
+    auto readHex = [this]()
+    {
+        unsigned int code = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const char c = take();
+            code <<= 4;
+
+            if (c >= '0' && c <= '9')
+                code |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                code |= c - 'A' + 10;
+            else
+                throwParseError("Invalid unicode escape");
+        }
+
+        return code;
+    };
+
+    while (true)
+    {
+        const char c = take();
+        if (c == '"')
+            return;
+        else if (c != '\\')
+        {
+            str += c;
+            continue;
+        }
+
+        const char escaped = take();
+        switch (escaped)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            str += escaped;
+            break;
+        case 'b':
+            str += '\b';
+            break;
+        case 'f':
+            str += '\f';
+            break;
+        case 'n':
+            str += '\n';
+            break;
+        case 'r':
+            str += '\r';
+            break;
+        case 't':
+            str += '\t';
+            break;
+        case 'u':
+        {
+            unsigned int code = readHex();
+
+            // Combine surrogate pairs.
+            if (code >= 0xD800 && code <= 0xDBFF)
+            {
+                expect('\\');
+                expect('u');
+                const unsigned int low = readHex();
+                if (low < 0xDC00 || low > 0xDFFF)
+                    throwParseError("Invalid surrogate pair");
+
+                code = (((code - 0xD800) << 10) | (low - 0xDC00)) + 0x10000;
+            }
+
+            appendUtf8(str, code);
+            break;
+        }
+        default:
+            throwParseError("Invalid escape character in string");
+        }
+    }
 }
 
-FileVersion InputArchive::version() const
+long long InputArchive::readInteger()
 {
-    return myVersion;
+    skipWhitespace();
+
+    bool negative = false;
+    if (peek() == '-')
+    {
+        take();
+        negative = true;
+    }
+
+    const int first = peek();
+    if (first < '0' || first > '9')
+        throwParseError("Expected an integer");
+
+    long long val = 0;
+    while (true)
+    {
+        const int c = peek();
+        if (c < '0' || c > '9')
+            break;
+
+        val = val * 10 + (take() - '0');
+        if (val > std::numeric_limits<unsigned int>::max())
+            throw std::overflow_error("Invalid integer value");
+    }
+
+    return negative ? -val : val;
+}
+
+void InputArchive::skipValue()
+{
+    skipWhitespace();
+
+    switch (peek())
+    {
+    case '{':
+    case '[':
+    {
+        const char end = take() == '{' ? '}' : ']';
+        myIsFirstItem = true;
+        endItems(end);
+        break;
+    }
+    case '"':
+    {
+        std::string str;
+        readString(str);
+        break;
+    }
+    case 't':
+        expectLiteral("true");
+        break;
+    case 'f':
+        expectLiteral("false");
+        break;
+    case 'n':
+        expectLiteral("null");
+        break;
+    default:
+        readInteger();
+
+        // Skip the fractional part or exponent of non-integer numbers.
+        while (true)
+        {
+            const int c = peek();
+            if (!(c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-' ||
+                  (c >= '0' && c <= '9')))
+            {
+                break;
+            }
+
+            take();
+        }
+    }
 }
 
 OutputArchive::OutputArchive(std::ostream &os, FileVersion version)
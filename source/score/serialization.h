@@ -19,22 +19,26 @@
 #define SCORE_SERIALIZATION_H
 
 #include <array>
+#include <boost/container/small_vector.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/optional.hpp>
-#include <boost/variant.hpp>
 #include <bitset>
 #include "fileversion.h"
+#include <limits>
 #include <map>
-#include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
-#include <stack>
 #include <stdexcept>
+#include <streambuf>
+#include <util/copyonwrite.h>
 #include <util/rapidjson_iostreams.h>
 #include <vector>
 
 namespace ScoreUtils
 {
+/// Reads a JSON document while it is being parsed, without building a DOM.
+/// The members of each object are expected to appear in the same order as
+/// they are read by the serialize() methods.
 class InputArchive
 {
 public:
@@ -45,74 +49,40 @@ public:
     template <typename T>
     void operator()(const std::string &expectedName, T &obj)
     {
-        if (expectedName != name())
-        {
-            throw std::runtime_error(
-                std::string("Unexpected or missing JSON data: found ") +
-                name() + ", expected " + expectedName);
-        }
-
-        read(obj);
-        advance();
-    }
-
-private:
-    typedef rapidjson::GenericValue<rapidjson::UTF8<> > JSONValue;
-
-    struct ValueVisitor : public boost::static_visitor<const JSONValue &>
-    {
-        const JSONValue &operator()(
-            const JSONValue::ConstMemberIterator &it) const
-        {
-            return it->value;
-        }
-
-        const JSONValue &operator()(
-            const JSONValue::ConstValueIterator &it) const
-        {
-            return *it;
-        }
-    };
+        if (!nextItem('}'))
+            throwUnexpected("end of object", expectedName);
 
-    struct NameVisitor : public boost::static_visitor<std::string>
-    {
-        std::string operator()(const JSONValue::ConstMemberIterator &it) const
-        {
-            return it->name.GetString();
-        }
-
-        std::string operator()(const JSONValue::ConstValueIterator &) const
-        {
-            throw std::logic_error("Cannot read the name of an array element");
-        }
-    };
+        readString(myName);
+        if (expectedName != myName)
+            throwUnexpected(myName, expectedName);
 
-    struct AdvanceVisitor : public boost::static_visitor<void>
-    {
-        template <typename Iterator>
-        void operator()(Iterator &it) const
-        {
-            ++it;
-        }
-    };
-
-    void advance()
-    {
-        AdvanceVisitor visitor;
-        myIterators.top().apply_visitor(visitor);
-    }
+        skipWhitespace();
+        expect(':');
 
-    std::string name() const
-    {
-        NameVisitor visitor;
-        return myIterators.top().apply_visitor(visitor);
+        read(obj);
     }
 
-    const JSONValue &value() const
-    {
-        ValueVisitor visitor;
-        return myIterators.top().apply_visitor(visitor);
-    }
+private:
+    void throwUnexpected(const std::string &found,
+                         const std::string &expected) const;
+    void throwParseError(const std::string &msg) const;
+
+    inline int peek();
+    inline char take();
+    inline void skipWhitespace();
+    inline void expect(char c);
+    inline void expectLiteral(const char *literal);
+
+    /// Moves to the next member or array element, and returns false if the
+    /// end of the object or array was reached instead.
+    inline bool nextItem(char end);
+    /// Consumes the closing bracket of an object or array, skipping any
+    /// remaining members that were not read.
+    inline void endItems(char end);
+
+    void readString(std::string &str);
+    long long readInteger();
+    void skipValue();
 
     inline void read(int &val);
     inline void read(int8_t &val);
@@ -122,7 +92,19 @@ private:
     inline void read(std::string &str);
 
     template <typename T>
-    void read(std::vector<T> &vec);
+    void read(std::vector<T> &vec)
+    {
+        readSequence(vec);
+    }
+
+    template <typename T, size_t N>
+    void read(boost::container::small_vector<T, N> &vec)
+    {
+        readSequence(vec);
+    }
+
+    template <typename Sequence>
+    void readSequence(Sequence &vec);
 
     template <typename K, typename V, typename C>
     void read(std::map<K, V, C> &map);
@@ -136,30 +118,43 @@ private:
     template <typename T>
     void read(boost::optional<T> &val);
 
+    template <typename T>
+    void read(CopyOnWrite<T> &val)
+    {
+        read(val.getMutable());
+    }
+
     inline void read(boost::gregorian::date &date);
 
     template <typename T>
     typename std::enable_if<std::is_enum<T>::value>::type read(T &val)
     {
-        val = static_cast<T>(value().GetInt());
+        int int_val;
+        read(int_val);
+        val = static_cast<T>(int_val);
     }
 
     template <typename T>
     typename std::enable_if<std::is_class<T>::value>::type read(T &obj)
     {
-        myIterators.push(value().MemberBegin());
+        skipWhitespace();
+        expect('{');
+        myIsFirstItem = true;
+
         obj.serialize(*this, myVersion);
-        myIterators.pop();
+
+        endItems('}');
     }
 
-    Util::RapidJSON::IStreamWrapper myStream;
-    rapidjson::Document myDocument;
+    std::streambuf *myBuffer;
+    size_t myOffset;
     FileVersion myVersion;
-
-	// Iterate over both objects and arrays in a uniform manner.
-    typedef boost::variant<JSONValue::ConstMemberIterator,
-                           JSONValue::ConstValueIterator> Iterator;
-    std::stack<Iterator> myIterators;
+    /// Whether the next member or array element is the first one, and so is
+    /// not preceded by a comma.
+    bool myIsFirstItem;
+    /// Buffer for the most recent member name, which is reused to avoid
+    /// allocating a new string for each member.
+    std::string myName;
 };
 
 template <typename T>
@@ -195,7 +190,19 @@ private:
     inline void write(const std::string &str);
 
     template <typename T>
-    void write(const std::vector<T> &vec);
+    void write(const std::vector<T> &vec)
+    {
+        writeSequence(vec);
+    }
+
+    template <typename T, size_t N>
+    void write(const boost::container::small_vector<T, N> &vec)
+    {
+        writeSequence(vec);
+    }
+
+    template <typename Sequence>
+    void writeSequence(const Sequence &vec);
 
     template <typename K, typename V, typename C>
     void write(const std::map<K, V, C> &map);
@@ -209,6 +216,12 @@ private:
     template <typename T>
     void write(const boost::optional<T> &val);
 
+    template <typename T>
+    void write(const CopyOnWrite<T> &val)
+    {
+        write(val.get());
+    }
+
     inline void write(const boost::gregorian::date &date);
 
     template <typename T>
@@ -237,14 +250,95 @@ void save(std::ostream &output, const std::string &name, const T &obj)
     ar(name, obj);
 }
 
+int InputArchive::peek()
+{
+    return myBuffer->sgetc();
+}
+
+char InputArchive::take()
+{
+    const auto c = myBuffer->sbumpc();
+    if (c == std::char_traits<char>::eof())
+        throwParseError("Unexpected end of data");
+
+    ++myOffset;
+    return static_cast<char>(c);
+}
+
+void InputArchive::skipWhitespace()
+{
+    while (true)
+    {
+        const int c = peek();
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return;
+
+        myBuffer->sbumpc();
+        ++myOffset;
+    }
+}
+
+void InputArchive::expect(char c)
+{
+    if (take() != c)
+        throwParseError(std::string("Expected '") + c + "'");
+}
+
+void InputArchive::expectLiteral(const char *literal)
+{
+    for (; *literal; ++literal)
+        expect(*literal);
+}
+
+bool InputArchive::nextItem(char end)
+{
+    skipWhitespace();
+    if (peek() == end)
+        return false;
+
+    if (!myIsFirstItem)
+    {
+        expect(',');
+        skipWhitespace();
+    }
+
+    myIsFirstItem = false;
+    return true;
+}
+
+void InputArchive::endItems(char end)
+{
+    while (nextItem(end))
+    {
+        if (end == '}')
+        {
+            readString(myName);
+            skipWhitespace();
+            expect(':');
+        }
+
+        skipValue();
+    }
+
+    take();
+    myIsFirstItem = false;
+}
+
 void InputArchive::read(int &val)
 {
-    val = value().GetInt();
+    const long long int_val = readInteger();
+    if (int_val > std::numeric_limits<int>::max() ||
+        int_val < std::numeric_limits<int>::min())
+    {
+        throw std::overflow_error("Invalid int value");
+    }
+    val = static_cast<int>(int_val);
 }
 
 void InputArchive::read(int8_t &val)
 {
-    int int_val = value().GetInt();
+    int int_val;
+    read(int_val);
     if (int_val > std::numeric_limits<int8_t>::max())
         throw std::overflow_error("Invalid int8_t value");
     val = static_cast<int8_t>(int_val);
@@ -252,12 +346,16 @@ void InputArchive::read(int8_t &val)
 
 void InputArchive::read(unsigned int &val)
 {
-    val = value().GetUint();
+    const long long int_val = readInteger();
+    if (int_val < 0 || int_val > std::numeric_limits<unsigned int>::max())
+        throw std::overflow_error("Invalid unsigned int value");
+    val = static_cast<unsigned int>(int_val);
 }
 
 void InputArchive::read(uint8_t &val)
 {
-    unsigned int uint_val = value().GetUint();
+    unsigned int uint_val;
+    read(uint_val);
     if (uint_val > std::numeric_limits<uint8_t>::max())
         throw std::overflow_error("Invalid uint8_t value");
     val = static_cast<uint8_t>(uint_val);
@@ -265,60 +363,72 @@ void InputArchive::read(uint8_t &val)
 
 void InputArchive::read(bool &val)
 {
-    val = value().GetBool();
+    skipWhitespace();
+    if (peek() == 't')
+    {
+        expectLiteral("true");
+        val = true;
+    }
+    else
+    {
+        expectLiteral("false");
+        val = false;
+    }
 }
 
 void InputArchive::read(std::string &str)
 {
-    str = value().GetString();
+    readString(str);
 }
 
-template <typename T>
-void InputArchive::read(std::vector<T> &vec)
+template <typename Sequence>
+void InputArchive::readSequence(Sequence &vec)
 {
-    auto size = value().Size();
-    myIterators.push(value().Begin());
+    skipWhitespace();
+    expect('[');
+    myIsFirstItem = true;
 
-    vec.resize(size);
-    for (unsigned int i = 0; i < size; ++i)
+    vec.clear();
+    while (nextItem(']'))
     {
-        read(vec[i]);
-        advance();
+        vec.emplace_back();
+        read(vec.back());
     }
 
-    myIterators.pop();
+    endItems(']');
 }
 
 template <typename K, typename V, typename C>
 void InputArchive::read(std::map<K, V, C> &map)
 {
-    auto it = value().MemberBegin();
-    const long long size = std::distance(it, value().MemberEnd());
-    myIterators.push(it);
+    skipWhitespace();
+    expect('{');
+    myIsFirstItem = true;
 
-    for (long long i = 0; i < size; ++i)
+    while (nextItem('}'))
     {
-        const K key = boost::lexical_cast<K>(name());
-
-        V value;
-        read(value);
-        map[key] = value;
+        readString(myName);
+        const K key = boost::lexical_cast<K>(myName);
+        skipWhitespace();
+        expect(':');
 
-        advance();
+        read(map[key]);
     }
 
-    myIterators.pop();
+    endItems('}');
 }
 
 template <typename T, size_t N>
 void InputArchive::read(std::array<T, N> &arr)
 {
-    myIterators.push(value().MemberBegin());
+    skipWhitespace();
+    expect('{');
+    myIsFirstItem = true;
 
     for (size_t i = 0; i < N; ++i)
         (*this)(std::to_string(i), arr[i]);
 
-    myIterators.pop();
+    endItems('}');
 }
 
 template <size_t N>
@@ -332,8 +442,12 @@ void InputArchive::read(std::bitset<N> &bits)
 template <typename T>
 void InputArchive::read(boost::optional<T> &val)
 {
-    if (value().IsNull())
+    skipWhitespace();
+    if (peek() == 'n')
+    {
+        expectLiteral("null");
         val.reset();
+    }
     else
     {
         T data;
@@ -370,11 +484,11 @@ void OutputArchive::write(const std::string &str)
                     static_cast<rapidjson::SizeType>(str.length()));
 }
 
-template <typename T>
-void OutputArchive::write(const std::vector<T> &vec)
+template <typename Sequence>
+void OutputArchive::writeSequence(const Sequence &vec)
 {
     myStream.StartArray();
-    for (const T &obj : vec)
+    for (const auto &obj : vec)
         write(obj);
     myStream.EndArray();
 }
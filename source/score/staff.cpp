@@ -55,7 +55,7 @@ void Staff::setStringCount(int count)
     myStringCount = count;
 
     // Clean up notes / positions that are no longer valid.
-    for (Voice &voice : myVoices)
+    for (Voice &voice : myVoices.getMutable())
     {
         for (Position &pos : voice.getPositions())
         {
@@ -72,12 +72,12 @@ void Staff::setStringCount(int count)
 
 boost::iterator_range<Staff::VoiceIterator> Staff::getVoices()
 {
-    return boost::make_iterator_range(myVoices);
+    return boost::make_iterator_range(myVoices.getMutable());
 }
 
 boost::iterator_range<Staff::VoiceConstIterator> Staff::getVoices() const
 {
-    return boost::make_iterator_range(myVoices);
+    return boost::make_iterator_range(myVoices.get());
 }
 
 boost::iterator_range<Staff::DynamicIterator> Staff::getDynamics()
@@ -99,3 +99,16 @@ void Staff::removeDynamic(const Dynamic &dynamic)
 {
     ScoreUtils::removeObject(myDynamics, dynamic);
 }
+
+size_t Staff::getMemoryUsage(CountedValueSet &counted) const
+{
+    size_t size = myDynamics.capacity() * sizeof(Dynamic);
+
+    if (myVoices.markCounted(counted))
+    {
+        for (const Voice &voice : myVoices.get())
+            size += voice.getMemoryUsage(counted);
+    }
+
+    return size;
+}
@@ -22,6 +22,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include "dynamic.h"
 #include "fileversion.h"
+#include <util/copyonwrite.h>
 #include <vector>
 #include "voice.h"
 
@@ -79,10 +80,14 @@ public:
     /// Removes the specified dynamic from the staff.
     void removeDynamic(const Dynamic &dynamic);
 
+    /// Returns the approximate amount of memory used by the staff, excluding
+    /// any shared data that is already in the set.
+    size_t getMemoryUsage(CountedValueSet &counted) const;
+
 private:
     ClefType myClefType;
     int myStringCount;
-    std::array<Voice, NUM_VOICES> myVoices;
+    CopyOnWrite<VoiceList> myVoices;
     std::vector<Dynamic> myDynamics;
 };
 
@@ -18,7 +18,6 @@
 #include "system.h"
 
 #include <algorithm>
-#include <boost/range/adaptor/reversed.hpp>
 #include <cstddef>
 #include "utils.h"
 
@@ -44,27 +43,39 @@ bool System::operator==(const System &other) const
 
 boost::iterator_range<System::StaffIterator> System::getStaves()
 {
-    return boost::make_iterator_range(myStaves);
+    return boost::make_iterator_range(myStaves.getMutable());
 }
 
 boost::iterator_range<System::StaffConstIterator> System::getStaves() const
 {
-    return boost::make_iterator_range(myStaves);
+    return boost::make_iterator_range(myStaves.get());
+}
+
+uint64_t System::getStavesGeneration() const
+{
+    return myStaves.getGeneration();
 }
 
 void System::insertStaff(const Staff &staff)
 {
-    myStaves.push_back(staff);
+    myStaves.getMutable().push_back(staff);
+}
+
+void System::insertStaff(Staff &&staff)
+{
+    myStaves.getMutable().push_back(std::move(staff));
 }
 
 void System::insertStaff(const Staff &staff, int index)
 {
-    myStaves.insert(myStaves.begin() + index, staff);
+    std::vector<Staff> &staves = myStaves.getMutable();
+    staves.insert(staves.begin() + index, staff);
 }
 
 void System::removeStaff(int index)
 {
-    myStaves.erase(myStaves.begin() + index);
+    std::vector<Staff> &staves = myStaves.getMutable();
+    staves.erase(staves.begin() + index);
 }
 
 boost::iterator_range<System::BarlineIterator> System::getBarlines()
@@ -92,35 +103,17 @@ void System::removeBarline(const Barline &barline)
 
 const Barline *System::getPreviousBarline(int position) const
 {
-    for (const Barline &barline : boost::adaptors::reverse(myBarlines))
-    {
-        if (barline.getPosition() < position)
-            return &barline;
-    }
-
-    return nullptr;
+    return ScoreUtils::findPreviousByPosition(getBarlines(), position);
 }
 
 const Barline *System::getNextBarline(int position) const
 {
-    for (const Barline &barline : myBarlines)
-    {
-        if (barline.getPosition() > position)
-            return &barline;
-    }
-
-    return nullptr;
+    return ScoreUtils::findNextByPosition(getBarlines(), position);
 }
 
 Barline *System::getNextBarline(int position)
 {
-    for (Barline &barline : myBarlines)
-    {
-        if (barline.getPosition() > position)
-            return &barline;
-    }
-
-    return nullptr;
+    return ScoreUtils::findNextByPosition(getBarlines(), position);
 }
 
 boost::iterator_range<System::TempoMarkerIterator> System::getTempoMarkers()
@@ -243,6 +236,32 @@ void System::removeTextItem(const TextItem &text)
     ScoreUtils::removeObject(myTextItems, text);
 }
 
+template <typename T>
+static size_t getVectorMemoryUsage(const std::vector<T> &items)
+{
+    return items.capacity() * sizeof(T);
+}
+
+size_t System::getMemoryUsage(CountedValueSet &counted) const
+{
+    size_t size = sizeof(System) + getVectorMemoryUsage(myBarlines) +
+                  getVectorMemoryUsage(myTempoMarkers) +
+                  getVectorMemoryUsage(myAlternateEndings) +
+                  getVectorMemoryUsage(myDirections) +
+                  getVectorMemoryUsage(myPlayerChanges) +
+                  getVectorMemoryUsage(myChords) +
+                  getVectorMemoryUsage(myTextItems);
+
+    if (myStaves.markCounted(counted))
+    {
+        size += getVectorMemoryUsage(myStaves.get());
+        for (const Staff &staff : myStaves.get())
+            size += staff.getMemoryUsage(counted);
+    }
+
+    return size;
+}
+
 template <typename T>
 static void shift(const T &range, int position,
                   int offset)
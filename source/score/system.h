@@ -28,6 +28,7 @@
 #include "staff.h"
 #include "tempomarker.h"
 #include "textitem.h"
+#include <util/copyonwrite.h>
 #include <vector>
 
 class System
@@ -61,9 +62,13 @@ public:
     boost::iterator_range<StaffIterator> getStaves();
     /// Returns the set of staves in the system.
     boost::iterator_range<StaffConstIterator> getStaves() const;
+    /// Returns an identifier that changes whenever the staves are copied to a
+    /// new location (see CopyOnWrite::getGeneration).
+    uint64_t getStavesGeneration() const;
 
     /// Adds a new staff to the system.
     void insertStaff(const Staff &staff);
+    void insertStaff(Staff &&staff);
     void insertStaff(const Staff &staff, int index);
     /// Removes the specified staff from the system.
     void removeStaff(int index);
@@ -144,8 +149,13 @@ public:
     /// Removes the specified text item from the system.
     void removeTextItem(const TextItem &text);
 
+    /// Returns the approximate amount of memory used by the system, excluding
+    /// any shared data that is already in the set. The shared data is then
+    /// added to the set, so that it is only counted once across all copies.
+    size_t getMemoryUsage(CountedValueSet &counted) const;
+
 private:
-    std::vector<Staff> myStaves;
+    CopyOnWrite<std::vector<Staff>> myStaves;
     /// List of the barlines in the system. This will always contain at least
     /// two barlines - the start and end bars.
     std::vector<Barline> myBarlines;
@@ -20,21 +20,41 @@
 
 #include <algorithm>
 #include <boost/range/adaptor/filtered.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <utility>
+#include <vector>
 
 namespace ScoreUtils {
 
+    /// Compares an object's position against a position index. This can be
+    /// used to binary search a range, since insertObject() keeps objects
+    /// sorted by position.
+    struct ComparePosition
+    {
+        template <typename T>
+        bool operator()(const T &obj, int position) const
+        {
+            return obj.getPosition() < position;
+        }
+
+        template <typename T>
+        bool operator()(int position, const T &obj) const
+        {
+            return position < obj.getPosition();
+        }
+    };
+
     /// Returns the object at the given position index, or null.
     template <typename T>
     typename T::pointer findByPosition(const boost::iterator_range<T> &range,
                                        int position)
     {
-        size_t n = range.size();
-        for (size_t i = 0; i < n; ++i)
-        {
-            if (range[i].getPosition() == position)
-                return &range[i];
-        }
+        T it = std::lower_bound(range.begin(), range.end(), position,
+                                ComparePosition());
+        if (it != range.end() && it->getPosition() == position)
+            return &*it;
 
         return nullptr;
     }
@@ -42,16 +62,34 @@ namespace ScoreUtils {
     template <typename T>
     int findIndexByPosition(const boost::iterator_range<T> &range, int position)
     {
-        const int n = static_cast<int>(range.size());
-        for (int i = 0; i < n; ++i)
-        {
-            if (range[i].getPosition() == position)
-                return i;
-        }
+        T it = std::lower_bound(range.begin(), range.end(), position,
+                                ComparePosition());
+        if (it != range.end() && it->getPosition() == position)
+            return static_cast<int>(it - range.begin());
 
         return -1;
     }
 
+    /// Returns the first object after the given position index, or null.
+    template <typename T>
+    typename T::pointer findNextByPosition(
+        const boost::iterator_range<T> &range, int position)
+    {
+        T it = std::upper_bound(range.begin(), range.end(), position,
+                                ComparePosition());
+        return (it != range.end()) ? &*it : nullptr;
+    }
+
+    /// Returns the last object before the given position index, or null.
+    template <typename T>
+    typename T::pointer findPreviousByPosition(
+        const boost::iterator_range<T> &range, int position)
+    {
+        T it = std::lower_bound(range.begin(), range.end(), position,
+                                ComparePosition());
+        return (it != range.begin()) ? &*(it - 1) : nullptr;
+    }
+
     struct InPositionRange
     {
         InPositionRange(int left, int right) : myLeft(left), myRight(right)
@@ -69,10 +107,25 @@ namespace ScoreUtils {
         const int myRight;
     };
 
+    /// Returns the objects with positions in the range [left, right].
+    template <typename Range>
+    boost::iterator_range<typename boost::range_iterator<Range>::type>
+    findInRange(Range range, int left, int right)
+    {
+        auto first = std::lower_bound(boost::begin(range), boost::end(range),
+                                      left, ComparePosition());
+        auto last = (right < left) ? first
+                                   : std::upper_bound(first, boost::end(range),
+                                                      right, ComparePosition());
+        return boost::make_iterator_range(first, last);
+    }
+
+    /// Unlike findInRange(), this does not require the objects to be sorted
+    /// by position (e.g. while their positions are being modified).
     template <typename Range>
-    boost::filtered_range<InPositionRange, Range> findInRange(Range range,
-                                                              int left,
-                                                              int right)
+    boost::filtered_range<InPositionRange, Range> filterByPosition(Range range,
+                                                                   int left,
+                                                                   int right)
     {
         return boost::adaptors::filter(
             range, InPositionRange(left, right));
@@ -90,8 +143,10 @@ namespace ScoreUtils {
         }
     };
 
+    /// Inserts an object into a vector that is sorted by position. The
+    /// object is taken by value so that temporaries can be moved in.
     template <typename T>
-    void insertObject(std::vector<T> &objects, const T &obj)
+    void insertObject(std::vector<T> &objects, T obj)
     {
         // Avoid sorting unless we actually need to. This improves performance
         // quite a bit when, for example, we are importing from other file
@@ -99,7 +154,7 @@ namespace ScoreUtils {
         const bool needsSort = !objects.empty() &&
                 objects.back().getPosition() > obj.getPosition();
 
-        objects.push_back(obj);
+        objects.push_back(std::move(obj));
         if (needsSort)
             std::sort(objects.begin(), objects.end(), OrderByPosition<T>());
     }
@@ -0,0 +1,62 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "playbackorder.h"
+
+#include <score/score.h>
+#include <score/utils/repeatcontroller.h>
+
+PlaybackOrder::PlaybackOrder(const Score &score)
+{
+    RepeatController repeat_controller(score);
+
+    SystemLocation location(0, 0);
+    bool is_jump = false;
+
+    while (location.getSystem() < static_cast<int>(score.getSystems().size()))
+    {
+        const System &system = score.getSystems()[location.getSystem()];
+        const Barline *next_bar = system.getNextBarline(location.getPosition());
+
+        myBars.push_back({ location,
+                           repeat_controller.getRepeatNumber(location),
+                           is_jump });
+
+        // Move to the next barline and follow any directions / repeats /
+        // alternate endings.
+        const SystemLocation prev_location = location;
+        location.setPosition(next_bar->getPosition());
+
+        SystemLocation new_location;
+        is_jump = repeat_controller.checkForRepeat(prev_location, location,
+                                                   new_location);
+
+        // If we're at the end of the system, shift to the next system and
+        // also check for a position change there.
+        if (!is_jump &&
+            next_bar->getPosition() == system.getBarlines().back().getPosition())
+        {
+            location.setSystem(location.getSystem() + 1);
+            location.setPosition(0);
+
+            is_jump = repeat_controller.checkForRepeat(prev_location, location,
+                                                       new_location);
+        }
+
+        if (is_jump)
+            location = new_location;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SCORE_UTILS_PLAYBACKORDER_H
+#define SCORE_UTILS_PLAYBACKORDER_H
+
+#include <score/systemlocation.h>
+#include <vector>
+
+class Score;
+
+/// The order in which the bars of a score are played, after following any
+/// repeats, alternate endings and musical directions.
+class PlaybackOrder
+{
+public:
+    struct Bar
+    {
+        /// The location of the bar's starting barline.
+        SystemLocation myLocation;
+        /// The pass through the surrounding repeated section, starting from 1.
+        int myRepeatNumber;
+        /// Whether playback jumped to this bar due to a repeat or a musical
+        /// direction, rather than continuing on from the previous bar.
+        bool myIsJump;
+    };
+
+    explicit PlaybackOrder(const Score &score);
+
+    const std::vector<Bar> &getBars() const { return myBars; }
+
+private:
+    std::vector<Bar> myBars;
+};
+
+#endif
@@ -15,8 +15,8 @@
   * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
   
-#ifndef MIDI_REPEATCONTROLLER_H
-#define MIDI_REPEATCONTROLLER_H
+#ifndef SCORE_UTILS_REPEATCONTROLLER_H
+#define SCORE_UTILS_REPEATCONTROLLER_H
 
 #include <score/utils/directionindex.h>
 #include <score/utils/repeatindexer.h>
@@ -37,6 +37,10 @@ public:
                         const SystemLocation &currentLocation,
                         SystemLocation &newLocation);
 
+    /// Returns the current pass through the repeated section surrounding the
+    /// location, starting from 1.
+    int getRepeatNumber(const SystemLocation &location) const;
+
 private:
     DirectionIndex myDirectionIndex;
     RepeatIndexer myRepeatIndex;
@@ -254,7 +254,7 @@ static int copyNotes(ScoreLocation &dest, const ScoreLocation &src)
         {
             Position new_pos(pos);
             new_pos.setPosition(new_pos.getPosition() + offset);
-            dest.getVoice().insertPosition(new_pos);
+            dest.getVoice().insertPosition(std::move(new_pos));
         }
 
         for (const IrregularGrouping *group :
@@ -470,18 +470,16 @@ static void mergePlayerChanges(ScoreLocation &dest_loc,
         {
             // If there is only a player change in the bass score, carry over
             // the current active players from the guitar score.
-            guitar_change = ScoreUtils::getCurrentPlayers(
-                guitar_loc.getScore(), guitar_loc.getSystemIndex(),
-                guitar_loc.getPositionIndex());
+            guitar_change = guitar_loc.getScore().getCurrentPlayers(
+                guitar_loc.getSystemIndex(), guitar_loc.getPositionIndex());
         }
 
         if (!bass_change && bass_bar != end_bass_bar)
         {
             // If there is only a player change in the guitar score, carry over
             // the current active players from the bass score.
-            bass_change = ScoreUtils::getCurrentPlayers(
-                bass_loc.getScore(), bass_loc.getSystemIndex(),
-                bass_loc.getPositionIndex());
+            bass_change = bass_loc.getScore().getCurrentPlayers(
+                bass_loc.getSystemIndex(), bass_loc.getPositionIndex());
         }
 
         // Merge in data from only the active staves.
@@ -527,6 +525,7 @@ static void mergePlayerChanges(ScoreLocation &dest_loc,
             change.setPosition(dest_loc.getPositionIndex());
 
         dest_system.insertPlayerChange(change);
+        dest_loc.getScore().updatePlayerChangeIndex(dest_loc.getSystemIndex());
     }
 }
 
@@ -598,7 +597,7 @@ static void insertNewSystem(Score &score)
     System system;
     system.getBarlines().back().setPosition(std::numeric_limits<int>::max());
 
-    score.insertSystem(system);
+    score.insertSystem(std::move(system));
 }
 
 static void combineScores(Score &dest_score, Score &guitar_score,
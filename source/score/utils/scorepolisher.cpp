@@ -17,12 +17,14 @@
 
 #include "scorepolisher.h"
 
-#include <map>
+#include <algorithm>
+#include <functional>
 #include <score/score.h>
 #include <score/voiceutils.h>
 #include <score/utils.h>
-#include <unordered_map>
-#include <unordered_set>
+#include <util/threadpool.h>
+#include <utility>
+#include <vector>
 
 class TimeStamp
 {
@@ -42,7 +44,7 @@ public:
             return myTime < other.myTime;
     }
 
-    void advance(const boost::rational<int> &duration)
+    void advance(VoiceUtils::Ticks duration)
     {
         myTime += duration;
     }
@@ -54,34 +56,95 @@ public:
 
 private:
     /// The time from the start of the bar.
-    boost::rational<int> myTime;
+    VoiceUtils::Ticks myTime = 0;
     /// Grace notes occur at the same timestamp as the note that they precede,
     /// but need to appear before the actual note.
     boost::optional<int> myGraceNoteNumber;
 };
 
-static int getDefaultNoteSpacing(const boost::rational<int> &duration)
+/// The position assigned to each timestamp in a bar, sorted by timestamp.
+typedef std::vector<std::pair<TimeStamp, int>> TimestampPositions;
+
+/// The timestamp of each position in a bar, sorted by address.
+typedef std::vector<std::pair<const Position *, TimeStamp>> PositionTimestamps;
+
+/// Items that have already been moved, sorted by address.
+typedef std::vector<const void *> KnownItems;
+
+static int getDefaultNoteSpacing(VoiceUtils::Ticks duration)
+{
+    return std::max(
+        2 * static_cast<int>(duration / VoiceUtils::TICKS_PER_QUARTER), 1);
+}
+
+static TimestampPositions::iterator findTimestamp(
+    TimestampPositions &timestampPositions, const TimeStamp &timestamp)
+{
+    return std::lower_bound(
+        timestampPositions.begin(), timestampPositions.end(), timestamp,
+        [](const std::pair<TimeStamp, int> &entry, const TimeStamp &time) {
+            return entry.first < time;
+        });
+}
+
+static bool isTimestamp(const TimestampPositions &timestampPositions,
+                        TimestampPositions::const_iterator it,
+                        const TimeStamp &timestamp)
+{
+    return it != timestampPositions.end() && !(timestamp < it->first);
+}
+
+/// Returns the position for the timestamp, or 0 if it is not known.
+static int getTimestampPosition(TimestampPositions &timestampPositions,
+                                const TimeStamp &timestamp)
+{
+    auto it = findTimestamp(timestampPositions, timestamp);
+    return isTimestamp(timestampPositions, it, timestamp) ? it->second : 0;
+}
+
+static TimeStamp getPositionTimestamp(const PositionTimestamps &timestamps,
+                                      const Position &pos)
 {
-    return std::max(2 * boost::rational_cast<int>(duration), 1);
+    auto it = std::lower_bound(
+        timestamps.begin(), timestamps.end(), &pos,
+        [](const std::pair<const Position *, TimeStamp> &entry,
+           const Position *p) {
+            return std::less<const Position *>()(entry.first, p);
+        });
+
+    return (it != timestamps.end() && it->first == &pos) ? it->second
+                                                         : TimeStamp();
+}
+
+/// Returns false if the item was already known.
+static bool insertKnownItem(KnownItems &knownItems, const void *item)
+{
+    auto it = std::lower_bound(knownItems.begin(), knownItems.end(), item,
+                               std::less<const void *>());
+    if (it != knownItems.end() && *it == item)
+        return false;
+
+    knownItems.insert(it, item);
+    return true;
 }
 
 template <typename T>
 static void shiftItemsAtPosition(const T &items, int position, int newPosition,
-                                 std::unordered_set<const void *> &knownItems)
+                                 KnownItems &knownItems)
 {
-    for (auto &item : ScoreUtils::findInRange(items, position, position))
+    // Items might be temporarily out of order while they are being shifted.
+    for (auto &item : ScoreUtils::filterByPosition(items, position, position))
     {
-        if (knownItems.find(&item) != knownItems.end())
+        if (!insertKnownItem(knownItems, &item))
             continue;
 
-        knownItems.insert(&item);
         item.setPosition(newPosition);
     }
 }
 
-static void shiftAllItemsAtPosition(
-    System &system, Staff &staff, Voice &voice, int currentPosition,
-    int newPosition, std::unordered_set<const void *> &knownItems)
+static void shiftAllItemsAtPosition(System &system, Staff &staff, Voice &voice,
+                                    int currentPosition, int newPosition,
+                                    KnownItems &knownItems)
 {
     shiftItemsAtPosition(voice.getIrregularGroupings(), currentPosition,
                          newPosition, knownItems);
@@ -101,22 +164,24 @@ static void shiftAllItemsAtPosition(
                          newPosition, knownItems);
 }
 
-static void computeTimestampPosition(
-    const TimeStamp &timestamp, int minPosition,
-    std::map<TimeStamp, int> &timestampPositions)
+/// Assigns a position to the timestamp and returns it.
+static int computeTimestampPosition(const TimeStamp &timestamp,
+                                    int minPosition,
+                                    TimestampPositions &timestampPositions)
 {
     int position = 0;
 
     // If another voice has a note at this timestamp, use that position.
-    auto it = timestampPositions.find(timestamp);
-    if (it != timestampPositions.end())
+    auto it = findTimestamp(timestampPositions, timestamp);
+    if (isTimestamp(timestampPositions, it, timestamp))
+    {
         position = std::max(it->second, minPosition);
+        it->second = position;
+    }
     else
     {
         // If this timestamp falls in between two timestamps from another voice,
         // insert it and shift the following timestamps over if necessary.
-        it = timestampPositions.lower_bound(timestamp);
-
         if (it != timestampPositions.begin())
             position = std::max(boost::prior(it)->second + 1, minPosition);
         else
@@ -125,16 +190,30 @@ static void computeTimestampPosition(
         if (it != timestampPositions.end() && it->second <= position)
         {
             const int shiftAmount = (position - it->second) + 1;
-            for (; it != timestampPositions.end(); ++it)
-                it->second += shiftAmount;
+            for (auto shifted = it; shifted != timestampPositions.end();
+                 ++shifted)
+            {
+                shifted->second += shiftAmount;
+            }
         }
+
+        timestampPositions.insert(it, std::make_pair(timestamp, position));
     }
 
-    timestampPositions[timestamp] = position;
+    return position;
 }
 
 void ScoreUtils::polishSystem(System &system)
 {
+    // Compute the duration of each position once, rather than searching for
+    // irregular groups at every position in every bar.
+    std::vector<std::vector<VoiceUtils::Ticks>> durations;
+    for (const Staff &staff : system.getStaves())
+    {
+        for (const Voice &voice : staff.getVoices())
+            durations.push_back(VoiceUtils::getDurationTicks(voice));
+    }
+
     // Format each bar separately.
     for (Barline &leftBar : system.getBarlines())
     {
@@ -142,15 +221,18 @@ void ScoreUtils::polishSystem(System &system)
         if (!rightBar)
             break;
 
-        std::unordered_map<const Position *, TimeStamp> timestamps;
-        std::map<TimeStamp, int> timestampPositions;
+        PositionTimestamps timestamps;
+        TimestampPositions timestampPositions;
 
         // For each timestamp, compute the maximum position at that timestamp
         // for any staff.
+        auto voiceDurations = durations.cbegin();
         for (const Staff &staff : system.getStaves())
         {
             for (const Voice &voice : staff.getVoices())
             {
+                const std::vector<VoiceUtils::Ticks> &positionDurations =
+                    *voiceDurations++;
                 TimeStamp timestamp;
                 boost::optional<int> grace_note;
                 int currentPosition = 0;
@@ -166,14 +248,14 @@ void ScoreUtils::polishSystem(System &system)
 
                     timestamp.setGraceNoteNumber(grace_note);
 
-                    computeTimestampPosition(timestamp, currentPosition,
-                                             timestampPositions);
-                    boost::rational<int> duration =
-                        VoiceUtils::getDurationTime(voice, position);
+                    const int timestampPosition = computeTimestampPosition(
+                        timestamp, currentPosition, timestampPositions);
+                    const VoiceUtils::Ticks duration = positionDurations[
+                        &position - &voice.getPositions().front()];
 
-                    currentPosition = timestampPositions[timestamp] +
-                                      getDefaultNoteSpacing(duration);
-                    timestamps[&position] = timestamp;
+                    currentPosition =
+                        timestampPosition + getDefaultNoteSpacing(duration);
+                    timestamps.emplace_back(&position, timestamp);
                     timestamp.advance(duration);
                 }
 
@@ -187,14 +269,20 @@ void ScoreUtils::polishSystem(System &system)
         if (timestampPositions.empty())
             continue;
 
-        int maxPosition = std::max(1, timestampPositions.rbegin()->second);
+        std::sort(timestamps.begin(), timestamps.end(),
+                  [](const std::pair<const Position *, TimeStamp> &a,
+                     const std::pair<const Position *, TimeStamp> &b) {
+                      return std::less<const Position *>()(a.first, b.first);
+                  });
+
+        int maxPosition = std::max(1, timestampPositions.back().second);
 
         // Adjust!
         const int startPos =
             (leftBar.getPosition() == 0) ? 0 : leftBar.getPosition() + 1;
         const int oldEndPos = rightBar->getPosition();
         const int endPos = startPos + maxPosition;
-        std::unordered_set<const void *> knownItems;
+        KnownItems knownItems;
 
         if (endPos > oldEndPos)
         {
@@ -224,10 +312,11 @@ void ScoreUtils::polishSystem(System &system)
                 {
                     // Since we're moving around irregular groups, we need to
                     // have precomputed the durations of each position.
-                    TimeStamp timestamp = timestamps[&pos];
+                    TimeStamp timestamp = getPositionTimestamp(timestamps, pos);
                     const int currentPosition = pos.getPosition();
                     const int newPosition =
-                        startPos + timestampPositions[timestamp];
+                        startPos +
+                        getTimestampPosition(timestampPositions, timestamp);
 
                     // Move any irregular groups, etc that start at this
                     // position. If the group moves forward, we need to be
@@ -245,6 +334,10 @@ void ScoreUtils::polishSystem(System &system)
 
 void ScoreUtils::polishScore(Score &score)
 {
-    for (System &system : score.getSystems())
-        polishSystem(system);
+    // Each system is formatted independently, so they can be processed in
+    // parallel.
+    auto systems = score.getSystems();
+    ThreadPool::getShared().parallelFor(
+        static_cast<int>(systems.size()),
+        [&systems](int i) { polishSystem(systems[i]); });
 }
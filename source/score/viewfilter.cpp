@@ -52,7 +52,7 @@ bool FilterRule::accept(const Score &score, int system_index,
     std::vector<const PlayerChange *> player_changes;
 
     const PlayerChange *current_players =
-        ScoreUtils::getCurrentPlayers(score, system_index, 0);
+        score.getCurrentPlayers(system_index, 0);
     if (current_players)
         player_changes.push_back(current_players);
 
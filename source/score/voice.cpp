@@ -31,22 +31,27 @@ bool Voice::operator==(const Voice &other) const
 
 boost::iterator_range<Voice::PositionIterator> Voice::getPositions()
 {
-    return boost::make_iterator_range(myPositions);
+    return boost::make_iterator_range(myPositions.getMutable());
 }
 
 boost::iterator_range<Voice::PositionConstIterator> Voice::getPositions() const
 {
-    return boost::make_iterator_range(myPositions);
+    return boost::make_iterator_range(myPositions.get());
 }
 
 void Voice::insertPosition(const Position &position)
 {
-    ScoreUtils::insertObject(myPositions, position);
+    ScoreUtils::insertObject(myPositions.getMutable(), position);
+}
+
+void Voice::insertPosition(Position &&position)
+{
+    ScoreUtils::insertObject(myPositions.getMutable(), std::move(position));
 }
 
 void Voice::removePosition(const Position &position)
 {
-    ScoreUtils::removeObject(myPositions, position);
+    ScoreUtils::removeObject(myPositions.getMutable(), position);
 }
 
 boost::iterator_range<Voice::IrregularGroupingIterator>
@@ -70,3 +75,20 @@ void Voice::removeIrregularGrouping(const IrregularGrouping &group)
 {
     ScoreUtils::removeObject(myIrregularGroupings, group);
 }
+
+size_t Voice::getMemoryUsage(CountedValueSet &counted) const
+{
+    size_t size = myIrregularGroupings.capacity() * sizeof(IrregularGrouping);
+
+    if (myPositions.markCounted(counted))
+    {
+        size += myPositions.get().capacity() * sizeof(Position);
+        for (const Position &pos : myPositions.get())
+        {
+            if (pos.getNotes().size() > Position::INLINE_NOTE_CAPACITY)
+                size += pos.getNotes().size() * sizeof(Note);
+        }
+    }
+
+    return size;
+}
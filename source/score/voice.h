@@ -22,6 +22,7 @@
 #include "fileversion.h"
 #include "irregulargrouping.h"
 #include "position.h"
+#include <util/copyonwrite.h>
 #include <vector>
 
 class Voice
@@ -47,6 +48,7 @@ public:
 
     /// Adds a new position to the voice.
     void insertPosition(const Position &position);
+    void insertPosition(Position &&position);
     /// Removes any positions that satisfy the given predicate.
     template <typename Predicate>
     void removePositions(Predicate p);
@@ -64,8 +66,12 @@ public:
     /// Removes the specified irregular grouping from the voice.
     void removeIrregularGrouping(const IrregularGrouping &group);
 
+    /// Returns the approximate amount of memory used by the voice, excluding
+    /// any shared data that is already in the set.
+    size_t getMemoryUsage(CountedValueSet &counted) const;
+
 private:
-    std::vector<Position> myPositions;
+    CopyOnWrite<std::vector<Position>> myPositions;
     std::vector<IrregularGrouping> myIrregularGroupings;
 };
 
@@ -79,8 +85,9 @@ void Voice::serialize(Archive &ar, const FileVersion /*version*/)
 template <typename Predicate>
 void Voice::removePositions(Predicate p)
 {
-    myPositions.erase(std::remove_if(myPositions.begin(), myPositions.end(), p),
-                      myPositions.end());
+    std::vector<Position> &positions = myPositions.getMutable();
+    positions.erase(std::remove_if(positions.begin(), positions.end(), p),
+                    positions.end());
 }
 
 #endif
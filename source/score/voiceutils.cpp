@@ -17,11 +17,12 @@
 
 #include "voiceutils.h"
 
-#include <boost/range/adaptor/reversed.hpp>
 #include "score.h"
 #include "scorelocation.h"
 #include "utils.h"
 
+#include <algorithm>
+
 namespace VoiceUtils
 {
 
@@ -46,24 +47,12 @@ const Voice *getAdjacentVoice(const ScoreLocation &location, int offset)
 
 const Position *getNextPosition(const Voice &voice, int position)
 {
-    for (const Position &pos : voice.getPositions())
-    {
-        if (pos.getPosition() > position)
-            return &pos;
-    }
-
-    return nullptr;
+    return ScoreUtils::findNextByPosition(voice.getPositions(), position);
 }
 
 const Position *getPreviousPosition(const Voice &voice, int position)
 {
-    for (const Position &pos : boost::adaptors::reverse(voice.getPositions()))
-    {
-        if (pos.getPosition() < position)
-            return &pos;
-    }
-
-    return nullptr;
+    return ScoreUtils::findPreviousByPosition(voice.getPositions(), position);
 }
 
 const Note *getNextNote(const Voice &voice, int position, int string,
@@ -156,4 +145,66 @@ boost::rational<int> getDurationTime(const Voice &voice, const Position &pos)
 
     return duration;
 }
+
+/// Returns the duration of the position, ignoring irregular groupings.
+static Ticks getBaseDurationTicks(const Position &pos)
+{
+    if (pos.hasProperty(Position::Acciaccatura))
+        return 0;
+
+    Ticks duration =
+        4 * TICKS_PER_QUARTER / static_cast<int>(pos.getDurationType());
+
+    // Adjust for dotted notes.
+    if (pos.hasProperty(Position::Dotted))
+        duration += duration / 2;
+    if (pos.hasProperty(Position::DoubleDotted))
+        duration += duration * 3 / 4;
+
+    return duration;
+}
+
+static Ticks applyIrregularGrouping(Ticks duration,
+                                    const IrregularGrouping &group)
+{
+    return duration * group.getNotesPlayedOver() / group.getNotesPlayed();
+}
+
+Ticks getDurationTicks(const Voice &voice, const Position &pos)
+{
+    Ticks duration = getBaseDurationTicks(pos);
+
+    for (const IrregularGrouping *group :
+         getIrregularGroupsInRange(voice, pos.getPosition(), pos.getPosition()))
+    {
+        duration = applyIrregularGrouping(duration, *group);
+    }
+
+    return duration;
+}
+
+std::vector<Ticks> getDurationTicks(const Voice &voice)
+{
+    const auto &positions = voice.getPositions();
+
+    std::vector<Ticks> durations;
+    durations.reserve(positions.size());
+    for (const Position &pos : positions)
+        durations.push_back(getBaseDurationTicks(pos));
+
+    for (const IrregularGrouping &group : voice.getIrregularGroupings())
+    {
+        const int start = ScoreUtils::findIndexByPosition(
+            positions, group.getPosition());
+        if (start < 0)
+            continue;
+
+        const int end = std::min<int>(start + group.getLength(),
+                                      static_cast<int>(durations.size()));
+        for (int i = start; i < end; ++i)
+            durations[i] = applyIrregularGrouping(durations[i], group);
+    }
+
+    return durations;
+}
 }
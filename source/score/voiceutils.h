@@ -19,6 +19,7 @@
 #define SCORE_VOICEUTILS_H
 
 #include <boost/rational.hpp>
+#include <cstdint>
 #include <vector>
 
 class ScoreLocation;
@@ -66,6 +67,24 @@ std::vector<const IrregularGrouping *> getIrregularGroupsInRange(
 /// This does not include tempo, and the durations are relative to a
 /// quarter note (i.e. a quarter note is 1, eighth note is 1/2, etc).
 boost::rational<int> getDurationTime(const Voice &voice, const Position &pos);
+
+/// A duration measured in a fixed number of ticks per quarter note, which
+/// allows rhythmic arithmetic to use plain integers rather than rationals.
+typedef int64_t Ticks;
+
+/// The number of ticks in a quarter note (2^10 * 3^2 * 5 * 7 * 11 * 13).
+/// Any duration, including double dotted 64th notes, within an irregular
+/// grouping of up to 16 notes is a whole number of ticks.
+const Ticks TICKS_PER_QUARTER = 46126080;
+
+/// Returns the note duration in ticks. This is equivalent to
+/// getDurationTime() * TICKS_PER_QUARTER.
+Ticks getDurationTicks(const Voice &voice, const Position &pos);
+
+/// Returns the duration in ticks of each position in the voice, in the same
+/// order as Voice::getPositions(). The irregular groupings are only visited
+/// once, rather than being searched for at each position.
+std::vector<Ticks> getDurationTicks(const Voice &voice);
 }
 
 #endif
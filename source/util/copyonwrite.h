@@ -0,0 +1,96 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef UTIL_COPYONWRITE_H
+#define UTIL_COPYONWRITE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+
+/// The shared values that have already been counted when measuring the memory
+/// used by several copies of an object.
+typedef std::unordered_set<const void *> CountedValueSet;
+
+/// Stores a value that is shared between copies until one of them is
+/// modified. This allows cheap snapshots of large objects (e.g. for undo),
+/// since only the parts that are later modified need to be duplicated.
+///
+/// References obtained from getMutable() must not be held across a copy of
+/// the owning object, since they would then refer to the shared value.
+template <typename T>
+class CopyOnWrite
+{
+public:
+    CopyOnWrite()
+        : myValue(std::make_shared<T>()), myGeneration(nextGeneration())
+    {
+    }
+
+    // There are deliberately no move operations, so that a moved-from object
+    // still holds a valid value.
+    CopyOnWrite(const CopyOnWrite &other) = default;
+    CopyOnWrite &operator=(const CopyOnWrite &other) = default;
+
+    bool operator==(const CopyOnWrite &other) const
+    {
+        return myValue == other.myValue || *myValue == *other.myValue;
+    }
+
+    const T &get() const { return *myValue; }
+
+    /// Returns a modifiable value, making a private copy first if the value
+    /// is currently shared.
+    T &getMutable()
+    {
+        if (isShared())
+        {
+            myValue = std::make_shared<T>(*myValue);
+            myGeneration = nextGeneration();
+        }
+
+        return *myValue;
+    }
+
+    /// Returns an identifier for the stored value, which changes whenever the
+    /// value is copied to a new location. Unlike the value's address, an
+    /// identifier is never reused.
+    uint64_t getGeneration() const { return myGeneration; }
+
+    /// Returns whether the value is shared with another copy.
+    bool isShared() const { return myValue.use_count() > 1; }
+
+    /// Adds the value to the set, and returns false if it had already been
+    /// counted.
+    bool markCounted(CountedValueSet &counted) const
+    {
+        return counted.insert(myValue.get()).second;
+    }
+
+private:
+    static uint64_t nextGeneration()
+    {
+        static std::atomic<uint64_t> theGeneration(0);
+        return ++theGeneration;
+    }
+
+    std::shared_ptr<T> myValue;
+    uint64_t myGeneration;
+};
+
+#endif
@@ -0,0 +1,78 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef UTIL_SPSCQUEUE_H
+#define UTIL_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/// A fixed-size, lock-free queue that can be used to pass items from one
+/// producer thread to one consumer thread. Neither side ever blocks or
+/// allocates memory.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+public:
+    SpscQueue() : myHead(0), myTail(0)
+    {
+    }
+
+    /// Adds an item to the queue. This must only be called by the producer.
+    /// Returns false (and discards the item) if the queue is full.
+    bool push(const T &item)
+    {
+        const size_t tail = myTail.load(std::memory_order_relaxed);
+        const size_t next = increment(tail);
+        if (next == myHead.load(std::memory_order_acquire))
+            return false;
+
+        myItems[tail] = item;
+        myTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// Removes the oldest item from the queue. This must only be called by
+    /// the consumer. Returns false if the queue is empty.
+    bool pop(T &item)
+    {
+        const size_t head = myHead.load(std::memory_order_relaxed);
+        if (head == myTail.load(std::memory_order_acquire))
+            return false;
+
+        item = myItems[head];
+        myHead.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+private:
+    static size_t increment(size_t index)
+    {
+        return (index + 1) % (Capacity + 1);
+    }
+
+    /// One slot is always left empty to distinguish a full queue from an
+    /// empty queue.
+    std::array<T, Capacity + 1> myItems;
+    /// The next item to be read.
+    std::atomic<size_t> myHead;
+    /// The next slot to be written.
+    std::atomic<size_t> myTail;
+};
+
+#endif
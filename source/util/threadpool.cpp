@@ -0,0 +1,167 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace
+{
+/// State shared between the calling thread and the helper tasks of a
+/// parallelFor() call. Helper tasks may start after the call has returned
+/// (if the pool was busy), so this is reference counted.
+struct ParallelForState
+{
+    ParallelForState(int count, const std::function<void(int)> &fn)
+        : myCount(count), myFunction(fn), myNextIndex(0), myNumRunning(0)
+    {
+    }
+
+    /// Runs calls until there are no indices left.
+    void run()
+    {
+        int i;
+        while ((i = myNextIndex++) < myCount)
+        {
+            try
+            {
+                myFunction(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(myMutex);
+                if (!myException)
+                    myException = std::current_exception();
+
+                // Skip any remaining calls.
+                myNextIndex = myCount;
+            }
+        }
+    }
+
+    const int myCount;
+    const std::function<void(int)> myFunction;
+    std::atomic<int> myNextIndex;
+
+    std::mutex myMutex;
+    std::condition_variable myFinished;
+    /// The number of helper tasks that are currently running calls.
+    int myNumRunning;
+    std::exception_ptr myException;
+};
+}
+
+ThreadPool::ThreadPool(int num_threads) : myIsStopping(false)
+{
+    for (int i = 0; i < num_threads; ++i)
+        myThreads.emplace_back(&ThreadPool::runWorker, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        myIsStopping = true;
+    }
+
+    myTaskAdded.notify_all();
+    for (std::thread &thread : myThreads)
+        thread.join();
+}
+
+ThreadPool &ThreadPool::getShared()
+{
+    static ThreadPool thePool;
+    return thePool;
+}
+
+int ThreadPool::getDefaultThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &fn)
+{
+    if (count <= 0)
+        return;
+
+    auto state = std::make_shared<ParallelForState>(count, fn);
+
+    // The calling thread handles one share of the work itself.
+    const int num_helpers =
+        std::min(static_cast<int>(myThreads.size()), count - 1);
+    if (num_helpers > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            for (int i = 0; i < num_helpers; ++i)
+            {
+                myTasks.push_back([state]() {
+                    {
+                        std::lock_guard<std::mutex> lock(state->myMutex);
+                        ++state->myNumRunning;
+                    }
+
+                    state->run();
+
+                    std::lock_guard<std::mutex> lock(state->myMutex);
+                    --state->myNumRunning;
+                    state->myFinished.notify_all();
+                });
+            }
+        }
+
+        myTaskAdded.notify_all();
+    }
+
+    state->run();
+
+    // Every index has now been claimed, but helpers might still be running
+    // their last call. Helpers that have not started yet will not find any
+    // work, so there is no need to wait for them.
+    std::unique_lock<std::mutex> lock(state->myMutex);
+    state->myFinished.wait(lock,
+                           [&state]() { return state->myNumRunning == 0; });
+
+    if (state->myException)
+        std::rethrow_exception(state->myException);
+}
+
+void ThreadPool::runWorker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(myMutex);
+            myTaskAdded.wait(
+                lock, [this]() { return myIsStopping || !myTasks.empty(); });
+
+            if (myIsStopping && myTasks.empty())
+                return;
+
+            task = std::move(myTasks.front());
+            myTasks.pop_front();
+        }
+
+        task();
+    }
+}
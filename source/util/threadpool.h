@@ -0,0 +1,62 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_THREADPOOL_H
+#define UTIL_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// A fixed set of worker threads for running short, independent tasks (e.g.
+/// processing each system of a score).
+class ThreadPool
+{
+public:
+    /// Creates a pool with the given number of worker threads. By default,
+    /// there is one thread for each core.
+    explicit ThreadPool(int num_threads = getDefaultThreadCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Returns a pool that is shared by the whole application.
+    static ThreadPool &getShared();
+
+    /// Calls the function for each index in [0, count) and waits for all of
+    /// the calls to finish. The calling thread also runs some of the calls,
+    /// so this is safe to use from within another task. If any call throws,
+    /// the remaining calls are skipped and the exception is rethrown.
+    void parallelFor(int count, const std::function<void(int)> &fn);
+
+private:
+    static int getDefaultThreadCount();
+
+    void runWorker();
+
+    std::vector<std::thread> myThreads;
+    std::mutex myMutex;
+    std::condition_variable myTaskAdded;
+    std::deque<std::function<void()>> myTasks;
+    bool myIsStopping;
+};
+
+#endif
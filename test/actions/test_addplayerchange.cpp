@@ -34,7 +34,10 @@ TEST_CASE("Actions/AddPlayerChange", "")
     action.redo();
     REQUIRE(score.getSystems()[0].getPlayerChanges().size() == 1);
     REQUIRE(score.getSystems()[0].getPlayerChanges()[0].getPosition() == 3);
+    REQUIRE(score.getCurrentPlayers(1, 0) ==
+            &score.getSystems()[0].getPlayerChanges()[0]);
 
     action.undo();
     REQUIRE(score.getSystems()[0].getPlayerChanges().size() == 0);
+    REQUIRE(!score.getCurrentPlayers(1, 0));
 }
@@ -0,0 +1,60 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <actions/dirtyregion.h>
+
+TEST_CASE("Actions/DirtyRegion/Merge", "")
+{
+    const DirtyRegion staff(1, 2);
+
+    SECTION("Same staff")
+    {
+        const DirtyRegion merged = staff.merge(DirtyRegion(1, 2));
+        REQUIRE(!merged.isEntireSystem());
+        REQUIRE(merged.getSystemIndex() == 1);
+        REQUIRE(merged.getStaffIndex() == 2);
+    }
+
+    SECTION("Different staves")
+    {
+        const DirtyRegion merged = staff.merge(DirtyRegion(1, 0));
+        REQUIRE(!merged.isEntireScore());
+        REQUIRE(merged.isEntireSystem());
+        REQUIRE(merged.getSystemIndex() == 1);
+    }
+
+    SECTION("Entire system")
+    {
+        const DirtyRegion merged = DirtyRegion(1).merge(staff);
+        REQUIRE(merged.isEntireSystem());
+        REQUIRE(merged.getSystemIndex() == 1);
+        REQUIRE(staff.merge(DirtyRegion(1)).isEntireSystem());
+    }
+
+    SECTION("Different systems")
+    {
+        REQUIRE(staff.merge(DirtyRegion(0, 2)).isEntireScore());
+        REQUIRE(staff.merge(DirtyRegion(2)).isEntireScore());
+    }
+
+    SECTION("Entire score")
+    {
+        REQUIRE(staff.merge(DirtyRegion()).isEntireScore());
+        REQUIRE(DirtyRegion().merge(staff).isEntireScore());
+    }
+}
@@ -46,8 +46,11 @@ TEST_CASE("Actions/EditStaff", "")
     REQUIRE(next_system.getPlayerChanges()[0].getPosition() == 0);
 
     action.undo();
-    REQUIRE(staff.getStringCount() == 6);
-    REQUIRE(staff.getVoices()[0].getPositions().size() == 6);
+    // The staves are restored from the snapshot, so the previous reference
+    // to the staff is no longer valid.
+    const Staff &original_staff = system.getStaves()[0];
+    REQUIRE(original_staff.getStringCount() == 6);
+    REQUIRE(original_staff.getVoices()[0].getPositions().size() == 6);
     REQUIRE(system.getPlayerChanges()[0].getActivePlayers(0).size() == 1);
     REQUIRE(system.getPlayerChanges()[1].getActivePlayers(0).size() == 1);
     REQUIRE(next_system.getPlayerChanges().empty());
@@ -0,0 +1,193 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <actions/editstaff.h>
+#include <actions/removesystem.h>
+#include <actions/undomanager.h>
+#include <score/score.h>
+#include <string>
+#include <vector>
+#include "actionfixture.h"
+
+namespace
+{
+/// Records the redraws that are requested by the undo manager.
+struct RedrawRecorder
+{
+    explicit RedrawRecorder(UndoManager &manager)
+    {
+        QObject::connect(&manager, &UndoManager::fullRedrawNeeded,
+                         [this]() { myRedraws.push_back("score"); });
+        QObject::connect(&manager, &UndoManager::redrawNeeded,
+                         [this](int system) {
+                             myRedraws.push_back("system " +
+                                                 std::to_string(system));
+                         });
+        QObject::connect(
+            &manager, &UndoManager::staffRedrawNeeded,
+            [this](const DirtyRegion &region) {
+                myRedraws.push_back(
+                    "staff " + std::to_string(region.getSystemIndex()) + "," +
+                    std::to_string(region.getStaffIndex()));
+            });
+    }
+
+    std::vector<std::string> myRedraws;
+};
+}
+
+TEST_CASE_METHOD(ActionFixture, "Actions/UndoManager/MemoryBudget", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack(myScore);
+    manager.setActiveStackIndex(0);
+
+    const System original(myScore.getSystems()[0]);
+    manager.push(new EditStaff(myLocation, Staff::BassClef, 6), 0);
+    REQUIRE(manager.getMemoryUsage() > 0);
+
+    const System edited(myScore.getSystems()[0]);
+    manager.push(new RemoveSystem(myScore, 0),
+                 UndoManager::AFFECTS_ALL_SYSTEMS);
+    REQUIRE(myScore.getSystems().empty());
+
+    // The voices are shared by both snapshots, and should only be counted
+    // once.
+    CountedValueSet counted;
+    const size_t edited_usage = edited.getMemoryUsage(counted);
+    const size_t expected_usage =
+        edited_usage + original.getMemoryUsage(counted);
+
+    CountedValueSet original_counted;
+    REQUIRE(expected_usage <
+            edited_usage + original.getMemoryUsage(original_counted));
+    REQUIRE(manager.getMemoryUsage() == expected_usage);
+
+    // Reducing the budget should discard the oldest snapshot, which then
+    // can't be undone.
+    manager.setMemoryBudget(expected_usage - 1);
+    REQUIRE(manager.getMemoryUsage() == edited_usage);
+    REQUIRE(manager.canUndo());
+
+    manager.undo();
+    REQUIRE(myScore.getSystems().size() == 1);
+    REQUIRE(!manager.canUndo());
+
+    manager.undo();
+    REQUIRE(myScore.getSystems()[0].getStaves()[0].getClefType() ==
+            Staff::BassClef);
+}
+
+TEST_CASE_METHOD(ActionFixture, "Actions/UndoManager/UndoReleasesSnapshot", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack(myScore);
+    manager.setActiveStackIndex(0);
+
+    manager.push(new EditStaff(myLocation, Staff::BassClef, 6), 0);
+    manager.undo();
+
+    // After undoing, the score should not share any data with the command, so
+    // reading through the non-const accessors doesn't copy the staves.
+    const System &system = myScore.getSystems()[0];
+    const Staff *staff = &system.getStaves()[0];
+    const Position *position =
+        &system.getStaves()[0].getVoices()[0].getPositions()[0];
+    REQUIRE(staff->getClefType() == Staff::TrebleClef);
+
+    System &mutable_system = myScore.getSystems()[0];
+    REQUIRE(&mutable_system.getStaves()[0] == staff);
+    REQUIRE(&mutable_system.getStaves()[0].getVoices()[0].getPositions()[0] ==
+            position);
+
+    // Pushing another command deletes the undone command.
+    manager.push(new QUndoCommand("Test"), UndoManager::AFFECTS_ALL_SYSTEMS);
+    REQUIRE(staff->getClefType() == Staff::TrebleClef);
+    REQUIRE(position->getPosition() == 42);
+    REQUIRE(manager.getMemoryUsage() == 0);
+}
+
+TEST_CASE("Actions/UndoManager/RedrawSignals", "")
+{
+    Score score;
+    UndoManager manager;
+    manager.addNewUndoStack(score);
+    manager.setActiveStackIndex(0);
+    RedrawRecorder recorder(manager);
+    std::vector<std::string> &redraws = recorder.myRedraws;
+
+    SECTION("Single command")
+    {
+        manager.push(new QUndoCommand("Test"), 1);
+        manager.push(new QUndoCommand("Test"), DirtyRegion(1, 2));
+        manager.push(new QUndoCommand("Test"),
+                     UndoManager::AFFECTS_ALL_SYSTEMS);
+        REQUIRE(redraws == std::vector<std::string>(
+                               { "system 1", "staff 1,2", "score" }));
+
+        redraws.clear();
+        manager.undo();
+        manager.undo();
+        REQUIRE(redraws ==
+                std::vector<std::string>({ "score", "staff 1,2" }));
+    }
+
+    SECTION("Macro on a single staff")
+    {
+        manager.beginMacro("Macro");
+        manager.push(new QUndoCommand("Test"), DirtyRegion(1, 2));
+        manager.push(new QUndoCommand("Test"), DirtyRegion(1, 2));
+        REQUIRE(redraws.empty());
+        manager.endMacro();
+        REQUIRE(redraws == std::vector<std::string>({ "staff 1,2" }));
+
+        manager.undo();
+        REQUIRE(redraws ==
+                std::vector<std::string>({ "staff 1,2", "staff 1,2" }));
+    }
+
+    SECTION("Macro on several staves")
+    {
+        manager.beginMacro("Macro");
+        manager.push(new QUndoCommand("Test"), DirtyRegion(1, 2));
+        manager.push(new QUndoCommand("Test"), DirtyRegion(1, 0));
+        manager.endMacro();
+        REQUIRE(redraws == std::vector<std::string>({ "system 1" }));
+    }
+
+    SECTION("Nested macros")
+    {
+        // A nested macro is redrawn when it is finished, since the following
+        // commands might depend on it (e.g. the caret's location).
+        manager.beginMacro("Macro");
+        manager.beginMacro("Nested Macro");
+        manager.push(new QUndoCommand("Test"), DirtyRegion(1, 2));
+        manager.endMacro();
+        REQUIRE(redraws == std::vector<std::string>({ "staff 1,2" }));
+
+        manager.push(new QUndoCommand("Test"), DirtyRegion(0, 2));
+        manager.endMacro();
+        REQUIRE(redraws ==
+                std::vector<std::string>({ "staff 1,2", "staff 0,2" }));
+
+        redraws.clear();
+        manager.undo();
+        REQUIRE(redraws ==
+                std::vector<std::string>({ "staff 1,2", "staff 0,2" }));
+    }
+}
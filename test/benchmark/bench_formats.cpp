@@ -0,0 +1,225 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+#include "scoregenerator.h"
+
+#include <algorithm>
+#include <app/appinfo.h>
+#include <boost/filesystem/operations.hpp>
+#include <chrono>
+#include <formats/gpx/gpximporter.h>
+#include <formats/guitar_pro/guitarproimporter.h>
+#include <formats/powertab/powertabexporter.h>
+#include <formats/powertab/powertabimporter.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <iostream>
+#include <memory>
+#include <score/binaryserialization.h>
+#include <score/score.h>
+#include <score/serialization.h>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace Benchmarks
+{
+static const int theScoreSizes[] = { 10, 100, 1000 };
+
+/// A generated .pt2 file that is removed once the benchmark is finished.
+class TempFile
+{
+public:
+    TempFile(const Score &score, PowerTabExporter::Encoding encoding)
+        : myPath(boost::filesystem::temp_directory_path() /
+                 boost::filesystem::unique_path("pte-bench-%%%%-%%%%.pt2"))
+    {
+        PowerTabExporter exporter(encoding);
+        exporter.save(myPath, score);
+    }
+
+    ~TempFile()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(myPath, ec);
+    }
+
+    const boost::filesystem::path &getPath() const { return myPath; }
+
+private:
+    boost::filesystem::path myPath;
+};
+
+template <typename Importer>
+static void addImportBenchmark(Runner &runner, const std::string &name,
+                               const char *filename)
+{
+    runner.add(name + "/" + filename, [=]() {
+        const std::string path = AppInfo::getAbsolutePath(filename);
+
+        return [=](Stopwatch &) {
+            Importer importer;
+            Score score;
+            importer.load(path, score);
+        };
+    });
+}
+
+/// Accumulates the time spent in each stage of a Power Tab 1.7 import, and
+/// logs the averages once the benchmark is finished.
+class ImportStageTimes
+{
+public:
+    explicit ImportStageTimes(const std::string &name) : myName(name), myRuns(0)
+    {
+    }
+
+    ~ImportStageTimes()
+    {
+        if (myRuns == 0)
+            return;
+
+        for (auto &&stage : myTotals)
+        {
+            const double elapsed =
+                std::chrono::duration<double, std::milli>(stage.second)
+                    .count();
+            std::cerr << myName << ": " << stage.first << " took "
+                      << elapsed / myRuns << " ms" << std::endl;
+        }
+    }
+
+    void addRun() { ++myRuns; }
+
+    void add(const char *stage, PowerTabOldImporter::Clock::duration elapsed)
+    {
+        auto it = std::find_if(
+            myTotals.begin(), myTotals.end(),
+            [=](const Total &total) { return total.first == stage; });
+
+        if (it == myTotals.end())
+            myTotals.emplace_back(stage, elapsed);
+        else
+            it->second += elapsed;
+    }
+
+private:
+    typedef std::pair<std::string, PowerTabOldImporter::Clock::duration> Total;
+
+    std::string myName;
+    int myRuns;
+    std::vector<Total> myTotals;
+};
+
+static void addPowerTabOldImportBenchmark(Runner &runner,
+                                          const std::string &name,
+                                          const char *filename)
+{
+    runner.add(name + "/" + filename, [=]() {
+        const std::string path = AppInfo::getAbsolutePath(filename);
+        auto times = std::make_shared<ImportStageTimes>(name + "/" + filename);
+
+        return [=](Stopwatch &) {
+            PowerTabOldImporter importer;
+            importer.setTimingCallback(
+                [&](const char *stage,
+                    PowerTabOldImporter::Clock::duration elapsed) {
+                    times->add(stage, elapsed);
+                });
+
+            Score score;
+            importer.load(path, score);
+            times->addRun();
+        };
+    });
+}
+
+static void addPowerTabImportBenchmark(Runner &runner, const std::string &name,
+                                       PowerTabExporter::Encoding encoding,
+                                       int num_systems)
+{
+    runner.add(name + "/" + std::to_string(num_systems), [=]() {
+        Score score;
+        generateScore(score, num_systems);
+        auto file = std::make_shared<TempFile>(score, encoding);
+
+        return [=](Stopwatch &) {
+            PowerTabImporter importer;
+            Score loaded_score;
+            importer.load(file->getPath(), loaded_score);
+        };
+    });
+}
+
+void addFormatBenchmarks(Runner &runner)
+{
+    for (const char *filename :
+         { "data/barlines.ptb", "data/guitar_ins.ptb", "data/notes.ptb",
+           "data/positions.ptb", "data/merge_multibar_rests.ptb" })
+    {
+        addPowerTabOldImportBenchmark(runner, "Formats/PowerTabOldImport",
+                                      filename);
+    }
+
+    for (const char *filename :
+         { "data/barlines.gp5", "data/notes.gp5", "data/positions.gp5",
+           "data/text.gp5" })
+    {
+        addImportBenchmark<GuitarProImporter>(runner, "Formats/GuitarProImport",
+                                              filename);
+    }
+
+    addImportBenchmark<GpxImporter>(runner, "Formats/GpxImport",
+                                    "data/text.gpx");
+
+    for (int num_systems : theScoreSizes)
+    {
+        addPowerTabImportBenchmark(runner, "Formats/PowerTabImport/Json",
+                                   PowerTabExporter::Encoding::Json,
+                                   num_systems);
+        addPowerTabImportBenchmark(runner, "Formats/PowerTabImport/Binary",
+                                   PowerTabExporter::Encoding::Binary,
+                                   num_systems);
+    }
+
+    for (int num_systems : theScoreSizes)
+    {
+        runner.add("Serialization/OutputArchive/" + std::to_string(num_systems),
+                   [=]() {
+                       auto score = std::make_shared<Score>();
+                       generateScore(*score, num_systems);
+
+                       return [=](Stopwatch &) {
+                           std::ostringstream output;
+                           ScoreUtils::save(output, "score", *score);
+                       };
+                   });
+
+        runner.add(
+            "Serialization/BinaryOutputArchive/" + std::to_string(num_systems),
+            [=]() {
+                auto score = std::make_shared<Score>();
+                generateScore(*score, num_systems);
+
+                return [=](Stopwatch &) {
+                    std::ostringstream output;
+                    ScoreUtils::saveBinary(output, "score", *score);
+                };
+            });
+    }
+}
+}
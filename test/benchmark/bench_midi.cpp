@@ -0,0 +1,116 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+#include "scoregenerator.h"
+
+#include <memory>
+#include <midi/midieventcache.h>
+#include <midi/midieventlist.h>
+#include <midi/midifile.h>
+#include <midi/miditimeline.h>
+#include <score/score.h>
+
+namespace Benchmarks
+{
+void addMidiBenchmarks(Runner &runner)
+{
+    for (int num_systems : { 10, 100, 1000 })
+    {
+        runner.add("Midi/Load/" + std::to_string(num_systems), [=]() {
+            auto score = std::make_shared<Score>();
+            generateScore(*score, num_systems);
+
+            return [=](Stopwatch &) {
+                MidiFile::LoadOptions options;
+                options.myEnableMetronome = true;
+
+                MidiFile file;
+                file.load(*score, options);
+            };
+        });
+
+        // Generating the events for playback, which also merges the tracks
+        // into a single list and builds the timeline.
+        runner.add("Midi/LoadAndMerge/" + std::to_string(num_systems), [=]() {
+            auto score = std::make_shared<Score>();
+            generateScore(*score, num_systems);
+
+            return [=](Stopwatch &) {
+                MidiFile::LoadOptions options;
+                options.myEnableMetronome = true;
+                options.myRecordPositionChanges = true;
+
+                MidiFile file;
+                file.load(*score, options);
+
+                for (MidiEventList &track : file.getTracks())
+                    track.convertToAbsoluteTicks();
+
+                MidiTimeline timeline(MidiEventList::merge(file.getTracks()),
+                                      file.getTicksPerBeat(),
+                                      file.getPlayedBars());
+            };
+        });
+
+        // Finding the start of playback near the end of the score, using an
+        // existing timeline.
+        runner.add("Midi/Seek/" + std::to_string(num_systems), [=]() {
+            auto score = std::make_shared<Score>();
+            generateScore(*score, num_systems);
+
+            MidiFile::LoadOptions options;
+            options.myEnableMetronome = true;
+            options.myRecordPositionChanges = true;
+
+            MidiFile file;
+            file.load(*score, options);
+
+            for (MidiEventList &track : file.getTracks())
+                track.convertToAbsoluteTicks();
+
+            auto timeline = std::make_shared<MidiTimeline>(
+                MidiEventList::merge(file.getTracks()), file.getTicksPerBeat(),
+                file.getPlayedBars());
+
+            return [=](Stopwatch &) {
+                const MidiTimeline::Bar *bar =
+                    timeline->findBar(SystemLocation(num_systems - 1, 1));
+                timeline->getChannelState(bar->myGroup);
+            };
+        });
+
+        // Reloading the score for playback, with all bars already cached.
+        runner.add("Midi/LoadCached/" + std::to_string(num_systems), [=]() {
+            auto score = std::make_shared<Score>();
+            generateScore(*score, num_systems);
+
+            auto cache = std::make_shared<MidiEventCache>();
+            MidiFile::LoadOptions options;
+            options.myEnableMetronome = true;
+
+            MidiFile file;
+            file.load(*score, options, cache.get());
+
+            return [=](Stopwatch &) {
+                MidiFile file;
+                file.load(*score, options, cache.get());
+            };
+        });
+    }
+}
+}
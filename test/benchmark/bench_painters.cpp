@@ -0,0 +1,53 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+#include "scoregenerator.h"
+
+#include <memory>
+#include <painters/layoutinfo.h>
+#include <score/score.h>
+
+namespace Benchmarks
+{
+void addPainterBenchmarks(Runner &runner)
+{
+    for (int num_systems : { 10, 100, 1000 })
+    {
+        runner.add("Painters/LayoutInfo/" + std::to_string(num_systems), [=]() {
+            auto score = std::make_shared<Score>();
+            generateScore(*score, num_systems);
+
+            return [=](Stopwatch &) {
+                int system_index = 0;
+                for (const System &system : score->getSystems())
+                {
+                    int staff_index = 0;
+                    for (const Staff &staff : system.getStaves())
+                    {
+                        LayoutInfo layout(*score, system, system_index, staff,
+                                          staff_index);
+                        ++staff_index;
+                    }
+
+                    ++system_index;
+                }
+            };
+        });
+    }
+}
+}
@@ -0,0 +1,101 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+#include "scoregenerator.h"
+
+#include <memory>
+#include <score/score.h>
+#include <score/utils.h>
+#include <score/utils/scoremerger.h>
+#include <score/voice.h>
+
+namespace Benchmarks
+{
+/// Creates a voice containing a continuous run of 64th notes.
+static std::shared_ptr<Voice> createDenseVoice(int num_positions)
+{
+    auto voice = std::make_shared<Voice>();
+    for (int i = 0; i < num_positions; ++i)
+    {
+        Position pos(i, Position::SixtyFourthNote);
+        pos.insertNote(Note(i % 6, i % 12));
+        voice->insertPosition(pos);
+    }
+
+    return voice;
+}
+
+void addScoreBenchmarks(Runner &runner)
+{
+    for (int num_positions : { 64, 512, 4096 })
+    {
+        // Look up every position index in a dense passage, as is done when
+        // generating MIDI events or rendering a bar. The count is stored so
+        // that the lookups can't be optimized away.
+        runner.add("Score/FindByPosition/" + std::to_string(num_positions),
+                   [=]() {
+            auto voice = createDenseVoice(num_positions);
+            auto count = std::make_shared<int>(0);
+
+            return [=](Stopwatch &) {
+                for (int i = 0; i < num_positions; ++i)
+                {
+                    if (ScoreUtils::findByPosition(voice->getPositions(), i))
+                        ++*count;
+                }
+            };
+        });
+
+        // The same lookups with a linear scan over the voice, for comparison.
+        runner.add("Score/FindByPositionLinear/" +
+                       std::to_string(num_positions),
+                   [=]() {
+            auto voice = createDenseVoice(num_positions);
+            auto count = std::make_shared<int>(0);
+
+            return [=](Stopwatch &) {
+                for (int i = 0; i < num_positions; ++i)
+                {
+                    if (!ScoreUtils::filterByPosition(voice->getPositions(), i,
+                                                      i).empty())
+                        ++*count;
+                }
+            };
+        });
+    }
+
+    for (int num_systems : { 10, 100, 1000 })
+    {
+        runner.add("Score/Merge/" + std::to_string(num_systems), [=]() {
+            return [=](Stopwatch &stopwatch) {
+                // The merge modifies its inputs, so they are regenerated for
+                // each run.
+                stopwatch.pause();
+                Score guitar_score;
+                generateScore(guitar_score, num_systems, 1);
+                Score bass_score;
+                generateScore(bass_score, num_systems, 1);
+                Score dest;
+                stopwatch.resume();
+
+                ScoreMerger::merge(dest, guitar_score, bass_score);
+            };
+        });
+    }
+}
+}
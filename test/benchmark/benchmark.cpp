@@ -0,0 +1,139 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <app/appinfo.h>
+#include <numeric>
+#include <ostream>
+#include <rapidjson/prettywriter.h>
+#include <util/rapidjson_iostreams.h>
+
+namespace Benchmarks
+{
+Stopwatch::Stopwatch()
+    : myStart(Clock::now()), myElapsed(Clock::duration::zero()),
+      myIsRunning(true)
+{
+}
+
+void Stopwatch::pause()
+{
+    if (myIsRunning)
+    {
+        myElapsed += Clock::now() - myStart;
+        myIsRunning = false;
+    }
+}
+
+void Stopwatch::resume()
+{
+    if (!myIsRunning)
+    {
+        myStart = Clock::now();
+        myIsRunning = true;
+    }
+}
+
+double Stopwatch::elapsed() const
+{
+    Clock::duration total = myElapsed;
+    if (myIsRunning)
+        total += Clock::now() - myStart;
+
+    return std::chrono::duration<double, std::milli>(total).count();
+}
+
+Runner::Options::Options()
+    : myMinIterations(5), myMinTime(500), myMaxIterations(1000)
+{
+}
+
+void Runner::add(const std::string &name, const Setup &setup)
+{
+    myBenchmarks.push_back({ name, setup });
+}
+
+void Runner::run(const Options &options, std::ostream &output,
+                 std::ostream &log) const
+{
+    Util::RapidJSON::OStreamWrapper stream(output);
+    rapidjson::PrettyWriter<Util::RapidJSON::OStreamWrapper> writer(stream);
+
+    writer.StartObject();
+    writer.String("version");
+    writer.String(AppInfo::APPLICATION_VERSION);
+    writer.String("benchmarks");
+    writer.StartArray();
+
+    for (const Benchmark &benchmark : myBenchmarks)
+    {
+        if (benchmark.myName.find(options.myFilter) == std::string::npos)
+            continue;
+
+        log << benchmark.myName << "... " << std::flush;
+
+        Operation operation = benchmark.mySetup();
+
+        // Warm up before measuring.
+        {
+            Stopwatch stopwatch;
+            operation(stopwatch);
+        }
+
+        std::vector<double> times;
+        double total = 0;
+        while (static_cast<int>(times.size()) < options.myMinIterations ||
+               (total < options.myMinTime &&
+                static_cast<int>(times.size()) < options.myMaxIterations))
+        {
+            Stopwatch stopwatch;
+            operation(stopwatch);
+            stopwatch.pause();
+
+            times.push_back(stopwatch.elapsed());
+            total += times.back();
+        }
+
+        std::sort(times.begin(), times.end());
+        const double mean = total / times.size();
+        const double median = times[times.size() / 2];
+
+        log << median << " ms (median of " << times.size() << ")" << std::endl;
+
+        writer.StartObject();
+        writer.String("name");
+        writer.String(benchmark.myName.c_str());
+        writer.String("iterations");
+        writer.Uint(static_cast<unsigned int>(times.size()));
+        writer.String("min_ms");
+        writer.Double(times.front());
+        writer.String("median_ms");
+        writer.Double(median);
+        writer.String("mean_ms");
+        writer.Double(mean);
+        writer.String("max_ms");
+        writer.Double(times.back());
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+    output << std::endl;
+}
+}
@@ -0,0 +1,98 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEST_BENCHMARK_BENCHMARK_H
+#define TEST_BENCHMARK_BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Benchmarks
+{
+/// Measures the time spent in a benchmark's operation. Work that should not
+/// be measured (e.g. copying the input) can be excluded by pausing the
+/// stopwatch.
+class Stopwatch
+{
+public:
+    Stopwatch();
+
+    void pause();
+    void resume();
+
+    /// Returns the elapsed time in milliseconds.
+    double elapsed() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point myStart;
+    Clock::duration myElapsed;
+    bool myIsRunning;
+};
+
+/// The operation to be timed. It is run repeatedly, and the stopwatch is
+/// started before each run.
+typedef std::function<void(Stopwatch &)> Operation;
+/// Prepares the inputs for a benchmark and returns the operation to time.
+/// This is only called if the benchmark is selected to run.
+typedef std::function<Operation()> Setup;
+
+class Runner
+{
+public:
+    struct Options
+    {
+        Options();
+
+        /// Only run benchmarks whose name contains this string.
+        std::string myFilter;
+        /// The minimum number of timed runs for each benchmark.
+        int myMinIterations;
+        /// Keep running a benchmark until this much time (in milliseconds)
+        /// has been spent, unless the maximum number of runs is reached.
+        double myMinTime;
+        int myMaxIterations;
+    };
+
+    void add(const std::string &name, const Setup &setup);
+
+    /// Runs the selected benchmarks, writes the results as JSON to the
+    /// output stream, and logs progress to the log stream.
+    void run(const Options &options, std::ostream &output,
+             std::ostream &log) const;
+
+private:
+    struct Benchmark
+    {
+        std::string myName;
+        Setup mySetup;
+    };
+
+    std::vector<Benchmark> myBenchmarks;
+};
+
+void addFormatBenchmarks(Runner &runner);
+void addMidiBenchmarks(Runner &runner);
+void addPainterBenchmarks(Runner &runner);
+void addScoreBenchmarks(Runner &runner);
+}
+
+#endif
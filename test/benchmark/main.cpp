@@ -0,0 +1,84 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/program_options.hpp>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <QCoreApplication>
+
+int main(int argc, char *argv[])
+{
+    // Initialize QCoreApplication for any benchmarks that use
+    // QCoreApplication::applicationDirPath().
+    QCoreApplication app(argc, argv);
+
+    namespace po = boost::program_options;
+    po::options_description desc(
+        "Usage: pte_benchmarks [options]\n"
+        "Runs the benchmarks and writes the results as JSON.\n\nOptions");
+
+    Benchmarks::Runner::Options options;
+
+    try
+    {
+        desc.add_options()
+            ("help,h", "Displays this help.")
+            ("filter", po::value<std::string>(&options.myFilter),
+             "Only run benchmarks whose name contains this string.")
+            ("min-iterations",
+             po::value<int>(&options.myMinIterations),
+             "The minimum number of runs for each benchmark.")
+            ("min-time", po::value<double>(&options.myMinTime),
+             "The minimum time (ms) to spend running each benchmark.")
+            ("output,o", po::value<std::string>(),
+             "Write the results to this file instead of stdout.");
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        Benchmarks::Runner runner;
+        Benchmarks::addFormatBenchmarks(runner);
+        Benchmarks::addMidiBenchmarks(runner);
+        Benchmarks::addPainterBenchmarks(runner);
+        Benchmarks::addScoreBenchmarks(runner);
+
+        if (vm.count("output"))
+        {
+            boost::filesystem::ofstream output(vm["output"].as<std::string>());
+            runner.run(options, output, std::cerr);
+        }
+        else
+            runner.run(options, std::cout, std::cerr);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scoregenerator.h"
+
+#include <random>
+#include <score/score.h>
+
+namespace Benchmarks
+{
+static const int theBarsPerSystem = 4;
+static const int thePositionsPerBar = 8;
+
+void generateScore(Score &score, int num_systems, int num_staves)
+{
+    // The engine and its raw output (unlike the standard distributions) are
+    // the same on every platform.
+    std::minstd_rand rng(42);
+
+    for (int i = 0; i < num_staves; ++i)
+    {
+        Player player;
+        player.setDescription("Player " + std::to_string(i + 1));
+        score.insertPlayer(player);
+
+        Instrument instrument;
+        instrument.setDescription("Instrument " + std::to_string(i + 1));
+        instrument.setMidiPreset(static_cast<uint8_t>(24 + i));
+        score.insertInstrument(instrument);
+    }
+
+    for (int system_index = 0; system_index < num_systems; ++system_index)
+    {
+        System system;
+
+        for (int bar = 1; bar < theBarsPerSystem; ++bar)
+        {
+            system.insertBarline(
+                Barline(bar * thePositionsPerBar, Barline::SingleBar));
+        }
+        system.getBarlines().back().setPosition(theBarsPerSystem *
+                                                thePositionsPerBar);
+
+        if (system_index % 8 == 0)
+        {
+            TempoMarker marker(0);
+            marker.setBeatsPerMinute(90 + 10 * ((system_index / 8) % 6));
+            system.insertTempoMarker(marker);
+        }
+
+        // Swap the instruments every few systems.
+        if (system_index % 16 == 0)
+        {
+            PlayerChange change;
+            for (int staff = 0; staff < num_staves; ++staff)
+            {
+                const int instrument =
+                    (staff + system_index / 16) % num_staves;
+                change.insertActivePlayer(staff,
+                                          ActivePlayer(staff, instrument));
+            }
+            system.insertPlayerChange(change);
+        }
+
+        for (int staff_index = 0; staff_index < num_staves; ++staff_index)
+        {
+            const int string_count = staff_index % 2 == 0 ? 6 : 4;
+            Staff staff(string_count);
+
+            if (system_index % 4 == 0)
+            {
+                staff.insertDynamic(Dynamic(
+                    0, system_index % 8 == 0 ? Dynamic::mf : Dynamic::ff));
+            }
+
+            Voice &melody = staff.getVoices()[0];
+            Voice &bass = staff.getVoices()[1];
+
+            for (int pos = 0; pos < theBarsPerSystem * thePositionsPerBar;
+                 ++pos)
+            {
+                const int string = static_cast<int>(rng() % string_count);
+                Position eighth(pos, Position::EighthNote);
+                eighth.insertNote(Note(string, static_cast<int>(rng() % 13)));
+
+                // Add a few chords and articulations.
+                if (rng() % 4 == 0)
+                {
+                    eighth.insertNote(Note((string + 1) % string_count,
+                                           static_cast<int>(rng() % 13)));
+                }
+                if (rng() % 8 == 0)
+                    eighth.setProperty(Position::PalmMuting);
+
+                melody.insertPosition(eighth);
+
+                if (pos % 2 == 0)
+                {
+                    Position quarter(pos, Position::QuarterNote);
+                    quarter.insertNote(
+                        Note(string_count - 1, static_cast<int>(rng() % 5)));
+                    bass.insertPosition(quarter);
+                }
+            }
+
+            system.insertStaff(staff);
+        }
+
+        score.insertSystem(system);
+    }
+}
+}
@@ -0,0 +1,32 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEST_BENCHMARK_SCOREGENERATOR_H
+#define TEST_BENCHMARK_SCOREGENERATOR_H
+
+class Score;
+
+namespace Benchmarks
+{
+/// Fills the score with deterministic content, so that benchmarks are
+/// reproducible. Each system has four bars of notes in two voices for each
+/// staff, along with dynamics and occasional tempo markers and player
+/// changes.
+void generateScore(Score &score, int num_systems, int num_staves = 2);
+}
+
+#endif
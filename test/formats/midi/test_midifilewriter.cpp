@@ -0,0 +1,105 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <app/appinfo.h>
+#include <formats/midi/midifilewriter.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <midi/midievent.h>
+#include <midi/midieventlist.h>
+#include <score/score.h>
+
+#include <sstream>
+#include <stdexcept>
+
+TEST_CASE("Formats/MidiFileWriter/RunningStatus", "")
+{
+    MidiTrackEncoder encoder;
+    encoder.append(0, MidiEvent::noteOn(0, 1, 60, 100, SystemLocation()));
+    encoder.append(200, MidiEvent::noteOn(0, 1, 64, 100, SystemLocation()));
+    encoder.append(0, MidiEvent::noteOff(0, 1, 60, SystemLocation()));
+    encoder.append(0, MidiEvent::setTempo(0, 500000));
+    encoder.append(0, MidiEvent::noteOff(0, 1, 64, SystemLocation()));
+
+    const std::vector<uint8_t> expected = {
+        'M', 'T', 'r', 'k', 0, 0, 0, 23,
+        // The second note on event uses running status.
+        0x00, 0x91, 60, 100,
+        0x81, 0x48, 64, 100,
+        0x00, 0x81, 60, 127,
+        // The tempo change cancels running status.
+        0x00, 0xff, 0x51, 3, 0x07, 0xa1, 0x20,
+        0x00, 0x81, 64, 127
+    };
+
+    REQUIRE(encoder.getData() == expected);
+}
+
+TEST_CASE("Formats/MidiFileWriter/AppendBefore", "")
+{
+    MidiEventList events;
+    events.append(MidiEvent::noteOff(480, 0, 60, SystemLocation()));
+    events.append(MidiEvent::noteOn(0, 0, 60, 100, SystemLocation()));
+    events.append(MidiEvent::noteOn(960, 0, 62, 100, SystemLocation()));
+
+    MidiTrackEncoder encoder;
+    encoder.appendBefore(events, 960);
+    REQUIRE(events.size() == 1);
+
+    encoder.appendBefore(events, 2000);
+    REQUIRE(events.empty());
+
+    const std::vector<uint8_t> expected = {
+        'M', 'T', 'r', 'k', 0, 0, 0, 14,
+        0x00, 0x90, 60, 100,
+        0x83, 0x60, 0x80, 60, 127,
+        0x83, 0x60, 0x90, 62, 100
+    };
+
+    REQUIRE(encoder.getData() == expected);
+
+    // An event can't be added before the events that were already written.
+    events.append(MidiEvent::noteOff(500, 0, 62, SystemLocation()));
+    REQUIRE_THROWS_AS(encoder.appendBefore(events, 3000), std::logic_error);
+}
+
+TEST_CASE("Formats/MidiFileWriter/Streaming", "")
+{
+    // Streaming the events should produce the same file as generating all
+    // of the events up front.
+    for (const char *filename :
+         { "data/alternate_endings.ptb", "data/bends.ptb", "data/notes.ptb" })
+    {
+        Score score;
+        PowerTabOldImporter importer;
+        importer.load(AppInfo::getAbsolutePath(filename), score);
+
+        MidiFile::LoadOptions options;
+        options.myEnableMetronome = true;
+
+        MidiFile file;
+        file.load(score, options);
+
+        std::ostringstream expected;
+        MidiFileWriter(expected).write(file);
+
+        std::ostringstream actual;
+        MidiFileWriter(actual).write(score, options);
+
+        REQUIRE(actual.str() == expected.str());
+    }
+}
@@ -0,0 +1,121 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <app/appinfo.h>
+#include <boost/filesystem/operations.hpp>
+#include <formats/powertab/powertabexporter.h>
+#include <formats/powertab/powertabimporter.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <score/binaryserialization.h>
+#include <score/score.h>
+#include <sstream>
+
+/// Saves the score with the given encoding and loads it back in.
+static void roundTrip(PowerTabExporter::Encoding encoding, const Score &score,
+                      Score &copy)
+{
+    const boost::filesystem::path path =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("%%%%-%%%%-%%%%.pt2");
+
+    PowerTabExporter exporter(encoding);
+    exporter.save(path, score);
+
+    PowerTabImporter importer;
+    importer.load(path, copy);
+
+    boost::filesystem::remove(path);
+}
+
+TEST_CASE("Formats/PowerTabImport/BinaryRoundTrip", "")
+{
+    for (const char *filename :
+         { "data/merge_multibar_rests_correct.pt2", "data/test_viewfilter.pt2",
+           "data/test_editstaff.pt2" })
+    {
+        Score score;
+        PowerTabImporter importer;
+        importer.load(AppInfo::getAbsolutePath(filename), score);
+
+        Score json_copy;
+        roundTrip(PowerTabExporter::Encoding::Json, score, json_copy);
+        Score binary_copy;
+        roundTrip(PowerTabExporter::Encoding::Binary, score, binary_copy);
+
+        REQUIRE(json_copy == score);
+        REQUIRE(binary_copy == score);
+        REQUIRE(binary_copy == json_copy);
+    }
+}
+
+TEST_CASE("Formats/PowerTabImport/BinaryRoundTripOldFormat", "")
+{
+    for (const char *filename :
+         { "data/notes.ptb", "data/positions.ptb", "data/chordtext.ptb",
+           "data/guitar_ins.ptb", "data/song_header.ptb" })
+    {
+        Score score;
+        PowerTabOldImporter importer;
+        importer.load(AppInfo::getAbsolutePath(filename), score);
+
+        Score json_copy;
+        roundTrip(PowerTabExporter::Encoding::Json, score, json_copy);
+        Score binary_copy;
+        roundTrip(PowerTabExporter::Encoding::Binary, score, binary_copy);
+
+        REQUIRE(binary_copy == json_copy);
+    }
+}
+
+TEST_CASE("Formats/PowerTabImport/BinaryInvalidLength", "")
+{
+    std::ostringstream output;
+    ScoreUtils::saveBinary(output, "text", std::string("abc"));
+    std::string data = output.str();
+
+    // Replace the string's length with a value that is larger than the data.
+    const std::string huge_length = "\xff\xff\xff\xff\x0f";
+    REQUIRE(data[data.size() - 4] == 3);
+    data.replace(data.size() - 4, 1, huge_length);
+
+    std::istringstream input(data);
+    std::string text;
+    REQUIRE_THROWS_AS(ScoreUtils::loadBinary(input, "text", text),
+                      std::runtime_error);
+
+    // A length that is within the limit but past the end of the data should
+    // also be rejected.
+    data = output.str();
+    data.replace(data.size() - 4, 1, "\xe8\x07");
+    std::istringstream short_input(data);
+    REQUIRE_THROWS_AS(ScoreUtils::loadBinary(short_input, "text", text),
+                      std::runtime_error);
+
+    // The same check applies to the number of elements in a sequence.
+    std::ostringstream vec_output;
+    ScoreUtils::saveBinary(vec_output, "values", std::vector<int>{ 1, 2 });
+    data = vec_output.str();
+    REQUIRE(data[data.size() - 3] == 2);
+    data.replace(data.size() - 3, 1, "\x7f");
+
+    std::istringstream vec_input(data);
+    std::vector<int> values;
+    REQUIRE_THROWS_AS(ScoreUtils::loadBinary(vec_input, "values", values),
+                      std::runtime_error);
+}
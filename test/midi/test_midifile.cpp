@@ -0,0 +1,158 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <app/appinfo.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <midi/midieventcache.h>
+#include <midi/midieventlist.h>
+#include <midi/midifile.h>
+#include <score/score.h>
+
+static bool operator==(const MidiEvent &e1, const MidiEvent &e2)
+{
+    return e1.getTicks() == e2.getTicks() &&
+           e1.getLocation() == e2.getLocation() &&
+           e1.getDataSize() == e2.getDataSize() &&
+           std::equal(e1.getData(), e1.getData() + e1.getDataSize(),
+                      e2.getData());
+}
+
+static bool operator==(const MidiEventList &l1, const MidiEventList &l2)
+{
+    return l1.size() == l2.size() &&
+           std::equal(l1.begin(), l1.end(), l2.begin());
+}
+
+static void checkCachedLoad(const Score &score,
+                            const MidiFile::LoadOptions &options,
+                            MidiEventCache &cache)
+{
+    MidiFile expected;
+    expected.load(score, options);
+
+    MidiFile actual;
+    actual.load(score, options, &cache);
+
+    REQUIRE(actual.getTicksPerBeat() == expected.getTicksPerBeat());
+    REQUIRE(actual.getTracks().size() == expected.getTracks().size());
+    for (size_t i = 0; i < expected.getTracks().size(); ++i)
+        REQUIRE(actual.getTracks()[i] == expected.getTracks()[i]);
+}
+
+TEST_CASE("Midi/MidiEventList/Merge", "")
+{
+    std::vector<MidiEventList> lists(3);
+    lists[0].append(MidiEvent::noteOn(0, 0, 60, 100, SystemLocation()));
+    lists[0].append(MidiEvent::noteOff(480, 0, 60, SystemLocation()));
+    lists[1].append(MidiEvent::noteOn(240, 1, 62, 100, SystemLocation()));
+    lists[1].append(MidiEvent::noteOff(480, 1, 62, SystemLocation()));
+    lists[2].append(MidiEvent::setTempo(0, 500000));
+
+    MidiEventList merged = MidiEventList::merge(lists);
+    REQUIRE(merged.size() == 5);
+
+    // Events with the same tick are ordered by their list's index.
+    std::vector<MidiEvent> events(merged.begin(), merged.end());
+    REQUIRE(events[0] == lists[0].begin()[0]);
+    REQUIRE(events[1] == lists[2].begin()[0]);
+    REQUIRE(events[2] == lists[1].begin()[0]);
+    REQUIRE(events[3] == lists[0].begin()[1]);
+    REQUIRE(events[4] == lists[1].begin()[1]);
+
+    // This should match a stable sort of the concatenated lists.
+    MidiEventList expected;
+    for (const MidiEventList &list : lists)
+        expected.concat(list);
+    expected.sort();
+    REQUIRE(merged == expected);
+
+    REQUIRE(MidiEventList::merge({}).empty());
+}
+
+TEST_CASE("Midi/MidiEventList/RemoveBefore", "")
+{
+    MidiEventList list;
+    for (int i = 0; i < 10; ++i)
+        list.append(MidiEvent::noteOn(i * 10, 0, 60, 100, SystemLocation()));
+
+    list.removeBefore(15);
+    REQUIRE(list.size() == 8);
+    REQUIRE(list.begin()->getTicks() == 20);
+
+    // Removing events again after the storage is compacted.
+    list.removeBefore(75);
+    REQUIRE(list.size() == 2);
+    REQUIRE(list.begin()->getTicks() == 80);
+
+    // The removed events should not reappear in other operations.
+    list.append(MidiEvent::noteOn(85, 0, 60, 100, SystemLocation()));
+    list.sort();
+    REQUIRE(list.size() == 3);
+    REQUIRE(list.begin()[1].getTicks() == 85);
+
+    MidiEventList copy;
+    copy.concat(list);
+    REQUIRE(copy == list);
+    REQUIRE(MidiEventList::merge({ list }) == list);
+
+    list.removeBefore(1000);
+    REQUIRE(list.empty());
+}
+
+TEST_CASE("Midi/MidiFile/Cache", "")
+{
+    for (const char *filename :
+         { "data/alternate_endings.ptb", "data/bends.ptb", "data/notes.ptb" })
+    {
+        Score score;
+        PowerTabOldImporter importer;
+        importer.load(AppInfo::getAbsolutePath(filename), score);
+
+        MidiFile::LoadOptions options;
+        options.myEnableMetronome = true;
+        options.myRecordPositionChanges = true;
+
+        MidiEventCache cache;
+
+        // Populate the cache, and then load again using only cached bars.
+        checkCachedLoad(score, options, cache);
+        checkCachedLoad(score, options, cache);
+
+        // Edit a note and regenerate the system that contains it.
+        for (int i = 0; i < static_cast<int>(score.getSystems().size()); ++i)
+        {
+            Voice &voice = score.getSystems()[i].getStaves()[0].getVoices()[0];
+            for (Position &pos : voice.getPositions())
+            {
+                if (pos.getNotes().empty())
+                    continue;
+
+                Note &note = pos.getNotes()[0];
+                const int fret = note.getFretNumber();
+                note.setFretNumber(fret > 0 ? fret - 1 : fret + 1);
+                cache.invalidateSystem(i);
+                checkCachedLoad(score, options, cache);
+                break;
+            }
+        }
+
+        // Changing the options should not reuse the cached events.
+        options.myEnableMetronome = false;
+        checkCachedLoad(score, options, cache);
+    }
+}
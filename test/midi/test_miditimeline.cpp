@@ -0,0 +1,213 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <midi/miditimeline.h>
+#include <midi/playbackclock.h>
+#include <memory>
+
+static bool operator==(const MidiEvent &e1, const MidiEvent &e2)
+{
+    return e1.getTicks() == e2.getTicks() &&
+           e1.getLocation() == e2.getLocation() &&
+           e1.getDataSize() == e2.getDataSize() &&
+           std::equal(e1.getData(), e1.getData() + e1.getDataSize(),
+                      e2.getData());
+}
+
+static const int TICKS_PER_BEAT = 480;
+
+/// Plays bars A and B twice (with a repeat), followed by bar C. The tempo is
+/// doubled at the start of the second pass of bar B.
+static std::unique_ptr<MidiTimeline> makeTimeline()
+{
+    const SystemLocation bar_a(0, 1);
+    const SystemLocation bar_b(0, 5);
+    const SystemLocation bar_c(0, 9);
+
+    MidiEventList events;
+    events.append(MidiEvent::programChange(0, 0, 25));
+    events.append(MidiEvent::volumeChange(0, 0, 100));
+    events.append(MidiEvent::noteOn(0, 0, 60, 100, bar_a));
+
+    events.append(MidiEvent::noteOff(480, 0, 60, bar_a));
+    events.append(MidiEvent::noteOn(480, 0, 62, 100, bar_b));
+
+    // Changes in the middle of a bar.
+    for (const MidiEvent &event : MidiEvent::pitchWheelRange(720, 0, 12))
+        events.append(event);
+    events.append(MidiEvent::programChange(720, 0, 30));
+
+    events.append(MidiEvent::noteOff(960, 0, 62, bar_b));
+    events.append(MidiEvent::volumeChange(960, 0, 80));
+    events.append(MidiEvent::noteOn(960, 0, 60, 100, bar_a));
+
+    events.append(MidiEvent::noteOff(1440, 0, 60, bar_a));
+    events.append(MidiEvent::setTempo(1440, 250000));
+    events.append(MidiEvent::noteOn(1440, 0, 62, 100, bar_b));
+
+    events.append(MidiEvent::noteOff(1920, 0, 62, bar_b));
+    events.append(MidiEvent::noteOn(1920, 0, 64, 100, bar_c));
+
+    events.append(MidiEvent::noteOff(2400, 0, 64, bar_c));
+
+    std::vector<MidiFile::PlayedBar> bars = {
+        { bar_a, 0 }, { bar_b, 480 }, { bar_a, 960 }, { bar_b, 1440 },
+        { bar_c, 1920 }
+    };
+
+    return std::unique_ptr<MidiTimeline>(
+        new MidiTimeline(std::move(events), TICKS_PER_BEAT, bars));
+}
+
+TEST_CASE("Midi/MidiTimeline/Groups", "")
+{
+    std::unique_ptr<MidiTimeline> timeline = makeTimeline();
+    using std::chrono::milliseconds;
+
+    const std::vector<MidiTimeline::Group> &groups = timeline->getGroups();
+    REQUIRE(groups.size() == 7);
+    REQUIRE(groups[0].myTime == milliseconds(0));
+    REQUIRE(groups[1].myTime == milliseconds(500));
+    REQUIRE(groups[2].myTime == milliseconds(750));
+    REQUIRE(groups[3].myTime == milliseconds(1000));
+    REQUIRE(groups[4].myTime == milliseconds(1500));
+    REQUIRE(groups[4].myBeatDuration == 250000);
+    REQUIRE(groups[5].myTime == milliseconds(1750));
+    REQUIRE(groups[6].myTime == milliseconds(2000));
+
+    const std::vector<MidiTimeline::Bar> &bars = timeline->getBars();
+    REQUIRE(bars.size() == 5);
+    REQUIRE(bars[0].myGroup == 0);
+    REQUIRE(bars[1].myGroup == 1);
+    REQUIRE(bars[2].myGroup == 3);
+    REQUIRE(bars[3].myGroup == 4);
+    REQUIRE(bars[4].myGroup == 5);
+}
+
+TEST_CASE("Midi/MidiTimeline/FindBar", "")
+{
+    std::unique_ptr<MidiTimeline> timeline = makeTimeline();
+    const std::vector<MidiTimeline::Bar> &bars = timeline->getBars();
+
+    // Before the first bar.
+    REQUIRE(timeline->findBar(SystemLocation(0, 0)) == nullptr);
+
+    // Repeated bars should use the first pass.
+    REQUIRE(timeline->findBar(SystemLocation(0, 1)) == &bars[0]);
+    REQUIRE(timeline->findBar(SystemLocation(0, 4)) == &bars[0]);
+    REQUIRE(timeline->findBar(SystemLocation(0, 5)) == &bars[1]);
+    REQUIRE(timeline->findBar(SystemLocation(0, 8)) == &bars[1]);
+
+    REQUIRE(timeline->findBar(SystemLocation(0, 9)) == &bars[4]);
+    REQUIRE(timeline->findBar(SystemLocation(2, 0)) == &bars[4]);
+}
+
+TEST_CASE("Midi/MidiTimeline/FindGroup", "")
+{
+    std::unique_ptr<MidiTimeline> timeline = makeTimeline();
+    using std::chrono::microseconds;
+    using std::chrono::milliseconds;
+
+    REQUIRE(timeline->findGroup(milliseconds(0)) == 0);
+    REQUIRE(timeline->findGroup(microseconds(1)) == 1);
+    REQUIRE(timeline->findGroup(microseconds(499999)) == 1);
+    REQUIRE(timeline->findGroup(milliseconds(500)) == 1);
+    REQUIRE(timeline->findGroup(microseconds(500001)) == 2);
+    REQUIRE(timeline->findGroup(milliseconds(1750)) == 5);
+    REQUIRE(timeline->findGroup(milliseconds(2000)) == 6);
+    REQUIRE(timeline->findGroup(microseconds(2000001)) == 7);
+}
+
+TEST_CASE("Midi/MidiTimeline/ChannelState", "")
+{
+    std::unique_ptr<MidiTimeline> timeline = makeTimeline();
+
+    auto check = [&](size_t group, const std::vector<MidiEvent> &expected) {
+        std::vector<MidiEvent> messages = timeline->getChannelState(group);
+        REQUIRE(messages.size() == expected.size());
+        REQUIRE(std::equal(messages.begin(), messages.end(),
+                           expected.begin()));
+    };
+
+    // Nothing has been set before the first group, which is where playback
+    // starts if the location is before the first bar.
+    check(0, {});
+
+    check(1, { MidiEvent::programChange(0, 0, 25),
+               MidiEvent::volumeChange(0, 0, 100) });
+
+    // The changes from the middle of the first pass of bar B should be
+    // restored when starting at the second pass of bar A.
+    std::vector<MidiEvent> expected;
+    for (const MidiEvent &event : MidiEvent::pitchWheelRange(0, 0, 12))
+        expected.push_back(event);
+    expected.push_back(MidiEvent::programChange(0, 0, 30));
+    expected.push_back(MidiEvent::volumeChange(0, 0, 100));
+    check(3, expected);
+
+    // The volume changed at the start of the second pass of bar A.
+    expected.back() = MidiEvent::volumeChange(0, 0, 80);
+    check(4, expected);
+    check(7, expected);
+}
+
+TEST_CASE("Midi/PlaybackClock/Deadlines", "")
+{
+    using std::chrono::milliseconds;
+    const PlaybackClock::Clock::time_point start = PlaybackClock::Clock::now();
+
+    PlaybackClock clock(milliseconds(1000), 100, start);
+    REQUIRE(clock.getDeadline(milliseconds(1000)) == start);
+    REQUIRE(clock.getDeadline(milliseconds(1500)) == start + milliseconds(500));
+
+    PlaybackClock slow_clock(milliseconds(1000), 50, start);
+    REQUIRE(slow_clock.getDeadline(milliseconds(1500)) ==
+            start + milliseconds(1000));
+
+    // Changing the speed only affects times after the change.
+    clock.setSpeed(200, start + milliseconds(500));
+    REQUIRE(clock.getDeadline(milliseconds(1500)) == start + milliseconds(500));
+    REQUIRE(clock.getDeadline(milliseconds(2500)) ==
+            start + milliseconds(1000));
+}
+
+TEST_CASE("Midi/PlaybackClock/WaitUntil", "")
+{
+    using std::chrono::milliseconds;
+    std::atomic<bool> is_playing(true);
+    std::atomic<int> speed(100);
+
+    const PlaybackClock::Clock::time_point start = PlaybackClock::Clock::now();
+    PlaybackClock clock(milliseconds(0), 100, start);
+
+    REQUIRE(clock.waitUntil(milliseconds(5), is_playing, speed));
+    REQUIRE(PlaybackClock::Clock::now() >= start + milliseconds(5));
+
+    // A speed change is picked up while waiting.
+    speed = 200;
+    REQUIRE(clock.waitUntil(milliseconds(10), is_playing, speed));
+    REQUIRE(clock.getDeadline(milliseconds(20)) -
+                clock.getDeadline(milliseconds(10)) ==
+            milliseconds(5));
+
+    // Stop waiting if playback is stopped.
+    is_playing = false;
+    REQUIRE(!clock.waitUntil(milliseconds(60000), is_playing, speed));
+}
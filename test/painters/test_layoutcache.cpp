@@ -0,0 +1,120 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <app/viewoptions.h>
+#include <painters/layoutcache.h>
+#include <score/score.h>
+
+static void createScore(Score &score)
+{
+    System system;
+    for (int i = 0; i < 2; ++i)
+    {
+        Staff staff(6);
+        Position position(3);
+        position.insertNote(Note(2, 3));
+        staff.getVoices().front().insertPosition(position);
+        system.insertStaff(staff);
+    }
+
+    score.insertSystem(system);
+    score.insertSystem(system);
+}
+
+TEST_CASE("Painters/LayoutCache/Lookup", "")
+{
+    Score score;
+    createScore(score);
+    ViewOptions view_options;
+    LayoutCache cache(score, view_options);
+
+    REQUIRE(!cache.contains(0));
+
+    // The layouts are computed on the first lookup and then reused.
+    const LayoutConstPtr layout = cache.getLayout(0, 0);
+    REQUIRE(layout);
+    REQUIRE(cache.contains(0));
+    REQUIRE(!cache.contains(1));
+    REQUIRE(cache.getLayout(0, 0) == layout);
+    REQUIRE(cache.getLayouts(0).size() == 2);
+    REQUIRE(cache.getStaffOffset(0, 1) ==
+            cache.getStaffOffset(0, 0) + layout->getStaffHeight());
+
+    // Layouts that were computed elsewhere are also reused.
+    const System &system = score.getSystems()[1];
+    std::vector<LayoutConstPtr> layouts;
+    for (int i = 0; i < 2; ++i)
+    {
+        layouts.push_back(std::make_shared<LayoutInfo>(
+            score, system, 1, system.getStaves()[i], i));
+    }
+
+    cache.setLayouts(1, layouts);
+    REQUIRE(cache.contains(1));
+    REQUIRE(cache.getLayout(1, 0) == layouts[0]);
+
+    // Layouts for a different system should not be used.
+    cache.setLayouts(1, cache.getLayouts(0));
+    REQUIRE(cache.getLayout(1, 0) != layout);
+    REQUIRE(cache.getLayout(1, 0)->isCurrent(system, 0));
+}
+
+TEST_CASE("Painters/LayoutCache/Invalidate", "")
+{
+    Score score;
+    createScore(score);
+    ViewOptions view_options;
+    LayoutCache cache(score, view_options);
+
+    const LayoutConstPtr layout0 = cache.getLayout(0, 0);
+    const LayoutConstPtr layout1 = cache.getLayout(1, 0);
+
+    cache.invalidate(0);
+    REQUIRE(!cache.contains(0));
+    REQUIRE(cache.getLayout(0, 0) != layout0);
+    REQUIRE(cache.getLayout(1, 0) == layout1);
+
+    cache.clear();
+    REQUIRE(!cache.contains(0));
+    REQUIRE(!cache.contains(1));
+    REQUIRE(cache.getLayout(1, 0) != layout1);
+}
+
+TEST_CASE("Painters/LayoutCache/StavesCopied", "")
+{
+    Score score;
+    createScore(score);
+    ViewOptions view_options;
+    LayoutCache cache(score, view_options);
+
+    const LayoutConstPtr layout = cache.getLayout(0, 0);
+
+    // Modifying the staves while they are shared with a snapshot copies them,
+    // so the cached layouts would refer to the old staves.
+    const System snapshot(score.getSystems()[0]);
+    score.getSystems()[0].getStaves()[0].setClefType(Staff::BassClef);
+
+    REQUIRE(!layout->isCurrent(score.getSystems()[0], 0));
+    const LayoutConstPtr new_layout = cache.getLayout(0, 0);
+    REQUIRE(new_layout != layout);
+    REQUIRE(new_layout->isCurrent(score.getSystems()[0], 0));
+
+    // Adding a staff also requires a new layout for each staff.
+    score.getSystems()[0].insertStaff(Staff(6));
+    REQUIRE(cache.getLayouts(0).size() == 3);
+}
@@ -0,0 +1,117 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <cstdlib>
+#include <painters/systemtile.h>
+#include <QBrush>
+#include <QGraphicsEllipseItem>
+#include <QGraphicsLineItem>
+#include <QGraphicsRectItem>
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QPen>
+
+/// Returns the number of pixels that differ, allowing for small rounding
+/// differences in each channel.
+static int countDifferentPixels(const QImage &image1, const QImage &image2)
+{
+    REQUIRE(image1.size() == image2.size());
+
+    int count = 0;
+    for (int y = 0; y < image1.height(); ++y)
+    {
+        for (int x = 0; x < image1.width(); ++x)
+        {
+            const QRgb pixel1 = image1.pixel(x, y);
+            const QRgb pixel2 = image2.pixel(x, y);
+
+            if (std::abs(qRed(pixel1) - qRed(pixel2)) > 1 ||
+                std::abs(qGreen(pixel1) - qGreen(pixel2)) > 1 ||
+                std::abs(qBlue(pixel1) - qBlue(pixel2)) > 1 ||
+                std::abs(qAlpha(pixel1) - qAlpha(pixel2)) > 1)
+            {
+                ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+TEST_CASE("Painters/SystemTile/MatchesScene", "")
+{
+    QGraphicsScene scene;
+
+    auto system = new QGraphicsRectItem(0, 0, 100, 50);
+    system->setBrush(Qt::white);
+    system->setPos(30, 40);
+    scene.addItem(system);
+
+    // Translucent items, such as the dividers between staves.
+    auto line = new QGraphicsLineItem(10, 10, 90, 10, system);
+    line->setPen(QPen(Qt::black, 4));
+    line->setOpacity(0.5);
+
+    auto nested = new QGraphicsEllipseItem(0, 0, 20, 20, line);
+    nested->setPos(40, 20);
+    nested->setBrush(Qt::blue);
+
+    auto behind = new QGraphicsRectItem(-5, -5, 20, 20, system);
+    behind->setBrush(Qt::red);
+    behind->setFlag(QGraphicsItem::ItemStacksBehindParent);
+
+    auto hidden = new QGraphicsRectItem(60, 30, 10, 10, system);
+    hidden->setBrush(Qt::green);
+    hidden->hide();
+
+    SystemTile tile(*system);
+    const QRectF rect = tile.getPictureRect().toAlignedRect();
+
+    // Making the system transparent while its image is displayed should not
+    // affect the recording, which is made the first time it is requested.
+    system->setOpacity(0);
+    tile.getPicture();
+    system->setOpacity(1);
+
+    // Check the image at different zoom levels and device pixel ratios.
+    for (double scale : { 1.0, 2.0 })
+    {
+        for (double pixel_ratio : { 1.0, 2.0 })
+        {
+            const double pixel_scale = scale * pixel_ratio;
+            const QImage tile_image = SystemTile::rasterize(
+                tile.getPicture(), rect, scale, pixel_ratio);
+
+            QImage scene_image(tile_image.size(),
+                               QImage::Format_ARGB32_Premultiplied);
+            scene_image.fill(Qt::transparent);
+            QPainter painter(&scene_image);
+            scene.render(&painter, QRectF(scene_image.rect()),
+                         system->mapRectToScene(rect));
+            painter.end();
+
+            // The system's background should have been drawn.
+            const QPointF background =
+                (QPointF(80, 40) - rect.topLeft()) * pixel_scale;
+            REQUIRE(tile_image.pixel(background.toPoint()) ==
+                    qRgba(255, 255, 255, 255));
+
+            REQUIRE(countDifferentPixels(tile_image, scene_image) == 0);
+        }
+    }
+}
@@ -19,6 +19,9 @@
 
 #include <boost/lexical_cast.hpp>
 #include <score/note.h>
+#include <score/tuning.h>
+#include <sstream>
+#include <stdexcept>
 #include "test_serialization.h"
 
 TEST_CASE("Score/Note/SimpleProperties", "")
@@ -62,6 +65,36 @@ TEST_CASE("Score/Note/TappedHarmonic", "")
     REQUIRE_THROWS(note.getTappedHarmonicFret());
 }
 
+TEST_CASE("Score/Note/InvalidValues", "")
+{
+    Note note(3, 12);
+
+    REQUIRE_THROWS_AS(note.setString(-1), std::out_of_range);
+    REQUIRE_THROWS_AS(note.setString(Tuning::MAX_STRING_COUNT),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(note.setFretNumber(-1), std::out_of_range);
+    REQUIRE_THROWS_AS(note.setFretNumber(128), std::out_of_range);
+    REQUIRE_THROWS_AS(note.setTrilledFret(300), std::out_of_range);
+    REQUIRE_THROWS_AS(note.setTappedHarmonicFret(-2), std::out_of_range);
+    REQUIRE_THROWS_AS(Note(0, 1000), std::out_of_range);
+
+    REQUIRE(note.getString() == 3);
+    REQUIRE(note.getFretNumber() == 12);
+
+    // Out of range values in a file should also be rejected rather than
+    // truncated.
+    std::ostringstream output;
+    ScoreUtils::save(output, "note", note);
+    std::string data = output.str();
+    const std::string fret = "\"fret\" : 12";
+    REQUIRE(data.find(fret) != std::string::npos);
+    data.replace(data.find(fret), fret.size(), "\"fret\" : 268");
+
+    Note copy;
+    std::istringstream input(data);
+    REQUIRE_THROWS_AS(ScoreUtils::load(input, "note", copy), std::out_of_range);
+}
+
 TEST_CASE("Score/Note/ArtificialHarmonic", "")
 {
     Note note;
@@ -92,6 +125,26 @@ TEST_CASE("Score/Note/Bend", "")
     REQUIRE(!note.hasBend());
 }
 
+TEST_CASE("Score/Note/CopyWithBend", "")
+{
+    Note note(2, 5);
+    note.setBend(Bend(Bend::NormalBend, 4));
+    note.setArtificialHarmonic(ArtificialHarmonic(
+        ChordName::D, ChordName::NoVariation, ArtificialHarmonic::Octave::Loco));
+
+    // Modifying a copy should not affect the original note.
+    Note copy(note);
+    REQUIRE(copy == note);
+    copy.clearBend();
+    REQUIRE(!copy.hasBend());
+    REQUIRE(copy.hasArtificialHarmonic());
+    REQUIRE(note.hasBend());
+    REQUIRE(note.getBend().getBentPitch() == 4);
+
+    copy.clearArtificialHarmonic();
+    REQUIRE(copy == Note(2, 5));
+}
+
 TEST_CASE("Score/Note/LeftHandFingering", "")
 {
     Note note;
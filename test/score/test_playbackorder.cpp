@@ -0,0 +1,58 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <catch.hpp>
+
+#include <score/score.h>
+#include <score/utils/playbackorder.h>
+
+TEST_CASE("Score/PlaybackOrder/Repeats", "")
+{
+    Score score;
+
+    System system;
+    system.getBarlines()[0].setBarType(Barline::RepeatStart);
+    system.insertBarline(Barline(10, Barline::SingleBar));
+    system.getBarlines()[2].setBarType(Barline::RepeatEnd);
+    system.getBarlines()[2].setRepeatCount(2);
+    score.insertSystem(system);
+    score.insertSystem(System());
+
+    PlaybackOrder order(score);
+    const std::vector<PlaybackOrder::Bar> &bars = order.getBars();
+
+    REQUIRE(bars.size() == 5);
+
+    REQUIRE(bars[0].myLocation == SystemLocation(0, 0));
+    REQUIRE(bars[0].myRepeatNumber == 1);
+    REQUIRE(!bars[0].myIsJump);
+
+    REQUIRE(bars[1].myLocation == SystemLocation(0, 10));
+    REQUIRE(bars[1].myRepeatNumber == 1);
+    REQUIRE(!bars[1].myIsJump);
+
+    REQUIRE(bars[2].myLocation == SystemLocation(0, 0));
+    REQUIRE(bars[2].myRepeatNumber == 2);
+    REQUIRE(bars[2].myIsJump);
+
+    REQUIRE(bars[3].myLocation == SystemLocation(0, 10));
+    REQUIRE(bars[3].myRepeatNumber == 2);
+    REQUIRE(!bars[3].myIsJump);
+
+    REQUIRE(bars[4].myLocation == SystemLocation(1, 0));
+    REQUIRE(bars[4].myRepeatNumber == 1);
+    REQUIRE(!bars[4].myIsJump);
+}
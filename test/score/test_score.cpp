@@ -77,3 +77,59 @@ TEST_CASE("Score/Score/ViewFilters", "")
     REQUIRE(score.getViewFilters().size() == 1);
     REQUIRE(score.getViewFilters()[0] == filter1);
 }
+
+TEST_CASE("Score/Score/PlayerChangeIndex", "")
+{
+    Score score;
+    score.insertSystem(System());
+
+    System system;
+    PlayerChange change1(5);
+    system.insertPlayerChange(change1);
+    score.insertSystem(system);
+    score.insertSystem(System());
+
+    REQUIRE(!score.getCurrentPlayers(0, 10));
+    REQUIRE(!score.getCurrentPlayers(1, 4));
+    REQUIRE(score.getCurrentPlayers(1, 5) ==
+            &score.getSystems()[1].getPlayerChanges()[0]);
+    REQUIRE(score.getCurrentPlayers(2, 0) ==
+            &score.getSystems()[1].getPlayerChanges()[0]);
+
+    // Modify a system directly and update the index.
+    PlayerChange change2(3);
+    score.getSystems()[2].insertPlayerChange(change2);
+    score.updatePlayerChangeIndex(2);
+    REQUIRE(score.getCurrentPlayers(2, 2) ==
+            &score.getSystems()[1].getPlayerChanges()[0]);
+    REQUIRE(score.getCurrentPlayers(2, 3) ==
+            &score.getSystems()[2].getPlayerChanges()[0]);
+
+    // Inserting or removing systems should update the index.
+    score.insertSystem(System(), 0);
+    REQUIRE(score.getCurrentPlayers(3, 0) ==
+            &score.getSystems()[2].getPlayerChanges()[0]);
+
+    score.removeSystem(2);
+    REQUIRE(!score.getCurrentPlayers(2, 0));
+    REQUIRE(score.getCurrentPlayers(2, 3) ==
+            &score.getSystems()[2].getPlayerChanges()[0]);
+
+    // Removing the only player change should be reflected once the index is
+    // updated.
+    score.insertSystem(System());
+    REQUIRE(score.getCurrentPlayers(3, 0) ==
+            &score.getSystems()[2].getPlayerChanges()[0]);
+    score.getSystems()[2].removePlayerChange(change2);
+    score.updatePlayerChangeIndex(2);
+    REQUIRE(!score.getCurrentPlayers(3, 0));
+
+    // If the index is not updated, a removed player change should not be
+    // returned.
+    score.getSystems()[0].insertPlayerChange(change1);
+    score.getSystems()[2].insertPlayerChange(change2);
+    score.updatePlayerChangeIndex(0);
+    score.getSystems()[2].removePlayerChange(change2);
+    REQUIRE(score.getCurrentPlayers(3, 0) ==
+            &score.getSystems()[0].getPlayerChanges()[0]);
+}
@@ -203,3 +203,32 @@ TEST_CASE("Score/System/TextItems", "")
     REQUIRE(system.getTextItems().size() == 1);
     REQUIRE(system.getTextItems()[0] == text1);
 }
+
+TEST_CASE("Score/System/SharedCopies", "")
+{
+    System system;
+    system.insertStaff(Staff(6));
+    system.getStaves()[0].getVoices()[0].insertPosition(Position(3));
+
+    // A copy shares its staves until one of the systems is modified.
+    CountedValueSet counted;
+    const size_t full_usage = system.getMemoryUsage(counted);
+    const System copy(system);
+    const size_t shared_usage = copy.getMemoryUsage(counted);
+    REQUIRE(shared_usage < full_usage);
+
+    // Without counting the original system, the copy owns all of the data.
+    CountedValueSet copy_counted;
+    REQUIRE(copy.getMemoryUsage(copy_counted) == full_usage);
+
+    system.getStaves()[0].getVoices()[0].insertPosition(Position(5));
+    system.getStaves()[0].setClefType(Staff::BassClef);
+
+    REQUIRE(system.getStaves()[0].getVoices()[0].getPositions().size() == 2);
+    REQUIRE(copy.getStaves()[0].getVoices()[0].getPositions().size() == 1);
+    REQUIRE(copy.getStaves()[0].getClefType() == Staff::TrebleClef);
+    REQUIRE(!(copy == system));
+    counted.clear();
+    system.getMemoryUsage(counted);
+    REQUIRE(copy.getMemoryUsage(counted) > shared_usage);
+}
@@ -20,6 +20,7 @@
 #include <score/score.h>
 #include <score/system.h>
 #include <score/utils.h>
+#include <score/voice.h>
 
 TEST_CASE("Score/Utils/FindByPosition", "")
 {
@@ -47,3 +48,42 @@ TEST_CASE("Score/Utils/GetCurrentPlayers", "")
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 0, 7));
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 1, 0));
 }
+
+TEST_CASE("Score/Utils/FindInRange", "")
+{
+    Voice voice;
+    for (int i : { 1, 3, 4, 8 })
+        voice.insertPosition(Position(i));
+
+    auto range = ScoreUtils::findInRange(voice.getPositions(), 2, 4);
+    REQUIRE(range.size() == 2);
+    REQUIRE(range.front().getPosition() == 3);
+    REQUIRE(range.back().getPosition() == 4);
+
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 0, 8).size() == 4);
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 5, 7).empty());
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 9, 20).empty());
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 4, 3).empty());
+
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 4) == 2);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 5) == -1);
+}
+
+TEST_CASE("Score/Utils/FindAdjacentPosition", "")
+{
+    Voice voice;
+    for (int i : { 1, 3, 4, 8 })
+        voice.insertPosition(Position(i));
+
+    REQUIRE(ScoreUtils::findNextByPosition(voice.getPositions(), 0)
+                ->getPosition() == 1);
+    REQUIRE(ScoreUtils::findNextByPosition(voice.getPositions(), 4)
+                ->getPosition() == 8);
+    REQUIRE(!ScoreUtils::findNextByPosition(voice.getPositions(), 8));
+
+    REQUIRE(!ScoreUtils::findPreviousByPosition(voice.getPositions(), 1));
+    REQUIRE(ScoreUtils::findPreviousByPosition(voice.getPositions(), 4)
+                ->getPosition() == 3);
+    REQUIRE(ScoreUtils::findPreviousByPosition(voice.getPositions(), 100)
+                ->getPosition() == 8);
+}
@@ -42,3 +42,62 @@ TEST_CASE("Score/VoiceUtils/GetDurationTime", "")
     voice.insertIrregularGrouping(IrregularGrouping(7, 1, 3, 2));
     REQUIRE(VoiceUtils::getDurationTime(voice, position) == 4);
 }
+
+TEST_CASE("Score/VoiceUtils/GetDurationTicks", "")
+{
+    const Position::DurationType durations[] = {
+        Position::WholeNote,        Position::HalfNote,
+        Position::QuarterNote,      Position::EighthNote,
+        Position::SixteenthNote,    Position::ThirtySecondNote,
+        Position::SixtyFourthNote
+    };
+    const Position::SimpleProperty dots[] = { Position::Dotted,
+                                              Position::DoubleDotted };
+
+    // Check that the ticks match the rational durations for every duration
+    // type and irregular grouping that can be entered.
+    for (int notesPlayed = 2; notesPlayed <= 16; ++notesPlayed)
+    {
+        for (int notesPlayedOver = 2; notesPlayedOver <= 8; ++notesPlayedOver)
+        {
+            Voice voice;
+            int position = 0;
+            for (Position::DurationType duration : durations)
+            {
+                Position pos(position++, duration);
+                voice.insertPosition(pos);
+
+                for (Position::SimpleProperty dot : dots)
+                {
+                    Position dotted(position++, duration);
+                    dotted.setProperty(dot);
+                    voice.insertPosition(dotted);
+                }
+            }
+
+            Position grace(position++);
+            grace.setProperty(Position::Acciaccatura);
+            voice.insertPosition(grace);
+
+            // Leave the first position outside of the group.
+            voice.insertIrregularGrouping(IrregularGrouping(
+                1, position - 1, notesPlayed, notesPlayedOver));
+
+            const std::vector<VoiceUtils::Ticks> ticks =
+                VoiceUtils::getDurationTicks(voice);
+            REQUIRE(ticks.size() == voice.getPositions().size());
+
+            for (size_t i = 0; i < ticks.size(); ++i)
+            {
+                const Position &pos = voice.getPositions()[i];
+                const boost::rational<int> expected =
+                    VoiceUtils::getDurationTime(voice, pos) *
+                    static_cast<int>(VoiceUtils::TICKS_PER_QUARTER);
+
+                REQUIRE(expected.denominator() == 1);
+                REQUIRE(ticks[i] == expected.numerator());
+                REQUIRE(VoiceUtils::getDurationTicks(voice, pos) == ticks[i]);
+            }
+        }
+    }
+}
@@ -17,13 +17,17 @@
 
 #define CATCH_CONFIG_RUNNER
 #include <catch.hpp>
-#include <QCoreApplication>
+#include <QApplication>
 
 int main(int argc, char *argv[])
 {
-    // Initialize QCoreApplication for any tests that use
-    // QCoreApplication::applicationDirPath().
-    QCoreApplication app(argc, argv);
+    // Initialize QApplication for any tests that use
+    // QCoreApplication::applicationDirPath() or render graphics items. The
+    // offscreen platform allows this to run without a display.
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
 
     return Catch::Session().run(argc, argv);
 }
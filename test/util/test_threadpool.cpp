@@ -0,0 +1,63 @@
+/*
+  * Copyright (C) 2020 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <util/threadpool.h>
+#include <vector>
+
+TEST_CASE("Util/ThreadPool/ParallelFor")
+{
+    ThreadPool pool(3);
+
+    std::vector<int> values(1000, 0);
+    pool.parallelFor(static_cast<int>(values.size()),
+                     [&](int i) { values[i] += i; });
+
+    for (int i = 0; i < static_cast<int>(values.size()); ++i)
+        REQUIRE(values[i] == i);
+
+    // Nothing should be run for an empty range.
+    pool.parallelFor(0, [](int) { FAIL(); });
+}
+
+TEST_CASE("Util/ThreadPool/Nested")
+{
+    ThreadPool pool(2);
+
+    // Nested calls should not deadlock, even when every worker is busy.
+    std::atomic<int> total(0);
+    pool.parallelFor(8, [&](int) {
+        pool.parallelFor(8, [&](int) { ++total; });
+    });
+
+    REQUIRE(total == 64);
+}
+
+TEST_CASE("Util/ThreadPool/Exception")
+{
+    ThreadPool pool(2);
+
+    REQUIRE_THROWS_AS(pool.parallelFor(100,
+                                       [](int i) {
+                                           if (i == 50)
+                                               throw std::runtime_error("");
+                                       }),
+                      std::runtime_error);
+}